@@ -83,6 +83,135 @@ public:
     StateType* m_stateArray;
   };
 
+  // State for processing several channels stage by stage: every stage runs
+  // over a block of up to BlockSize samples before the next one starts, on
+  // all channels at once. The channels are interleaved, so the innermost
+  // loop is a Transposed Direct Form II step across the channels, which the
+  // compiler maps to SIMD lanes. Real is the precision of the states and the
+  // arithmetic: double, or float for twice the lanes. With double states the
+  // output equals that of TransposedDirectFormII. Each stage is a recursion,
+  // so this pays off from about four channels; for one or two, the sample
+  // by sample Cascade::process overlaps the stages better.
+  template <int Channels, typename Real>
+  class BlockStateBase : private DenormalPrevention
+  {
+  public:
+    enum { BlockSize = 64 };
+
+    int getNumChannels() const
+    {
+      return Channels;
+    }
+
+    // Process a block of samples on every channel
+    template <typename Sample>
+    void process (int numSamples,
+                  Sample* const* arrayOfChannels,
+                  const Cascade& c)
+    {
+      for (int offset = 0; offset < numSamples; offset += BlockSize)
+      {
+        const int n = numSamples - offset < BlockSize ?
+                      numSamples - offset : BlockSize;
+        for (int i = 0; i < n; ++i)
+          for (int ch = 0; ch < Channels; ++ch)
+            m_work[i*Channels + ch] =
+              static_cast<Real> (arrayOfChannels[ch][offset + i]);
+        processWork (n, c);
+        for (int ch = 0; ch < Channels; ++ch)
+          for (int i = 0; i < n; ++i)
+            arrayOfChannels[ch][offset + i] =
+              static_cast<Sample> (m_work[i*Channels + ch]);
+      }
+    }
+
+    // Process a block of interleaved samples, dest[i*Channels + channel]
+    template <typename Sample>
+    void processInterleaved (int numSamples, Sample* dest, const Cascade& c)
+    {
+      for (int offset = 0; offset < numSamples; offset += BlockSize)
+      {
+        const int n = numSamples - offset < BlockSize ?
+                      numSamples - offset : BlockSize;
+        Sample* block = dest + offset*Channels;
+        for (int i = 0; i < n*Channels; ++i)
+          m_work[i] = static_cast<Real> (block[i]);
+        processWork (n, c);
+        for (int i = 0; i < n*Channels; ++i)
+          block[i] = static_cast<Sample> (m_work[i]);
+      }
+    }
+
+  protected:
+    BlockStateBase (Real* stateArray, Real* work)
+      : m_stateArray (stateArray)
+      , m_work (work)
+    {
+    }
+
+  private:
+    // Per stage: load its state, filter the whole block, store it back.
+    void processWork (int numSamples, const Cascade& c)
+    {
+      Real* state = m_stateArray;
+      for (int stage = 0; stage < c.m_numStages; ++stage, state += 2*Channels)
+      {
+        const Biquad& s = c.m_stageArray[stage];
+        const Real b0 = static_cast<Real> (s.m_b0);
+        const Real b1 = static_cast<Real> (s.m_b1);
+        const Real b2 = static_cast<Real> (s.m_b2);
+        const Real a1 = static_cast<Real> (s.m_a1);
+        const Real a2 = static_cast<Real> (s.m_a2);
+        Real s1[Channels];
+        Real s2[Channels];
+        for (int ch = 0; ch < Channels; ++ch)
+        {
+          s1[ch] = state[ch];
+          s2[ch] = state[Channels + ch];
+        }
+
+        // The first stage adds ac(), which alternates in sign per sample
+        Real vsa = 0;
+        if (stage == 0)
+        {
+          vsa = static_cast<Real> (ac ());
+          if ((numSamples & 1) == 0)
+            ac ();
+        }
+
+        Real* x = m_work;
+        for (int i = 0; i < numSamples; ++i, x += Channels, vsa = -vsa)
+        {
+          // local copies keep the channel loop free of aliasing
+          Real in[Channels];
+          Real out[Channels];
+          for (int ch = 0; ch < Channels; ++ch)
+            in[ch] = x[ch];
+          for (int ch = 0; ch < Channels; ++ch)
+          {
+            out[ch] = s1[ch] + b0*in[ch] + vsa;
+            s1[ch] = s2[ch] + b1*in[ch] - a1*out[ch];
+            s2[ch] = b2*in[ch] - a2*out[ch];
+          }
+          for (int ch = 0; ch < Channels; ++ch)
+            x[ch] = out[ch];
+        }
+
+        for (int ch = 0; ch < Channels; ++ch)
+        {
+          state[ch] = s1[ch];
+          state[Channels + ch] = s2[ch];
+        }
+      }
+    }
+
+  protected:
+    // Per stage: s1 of every channel, then s2 of every channel
+    Real* m_stateArray;
+    // Interleaved samples of the current block
+    Real* m_work;
+  };
+
   struct Stage : Biquad
   {
   };
@@ -166,6 +295,29 @@ public:
     StateType m_states[MaxStages];
   };
 
+  // Interleaved states for Channels channels in the precision Real,
+  // processed stage by stage, see Cascade::BlockStateBase
+  template <int Channels, typename Real = double>
+  class BlockState : public Cascade::BlockStateBase <Channels, Real>
+  {
+  public:
+    BlockState()
+      : Cascade::BlockStateBase <Channels, Real> (m_states, m_work)
+    {
+      reset ();
+    }
+
+    void reset ()
+    {
+      for (int i = 0; i < 2*MaxStages*Channels; ++i)
+        m_states[i] = 0;
+    }
+
+  private:
+    Real m_states[2*MaxStages*Channels];
+    Real m_work[Cascade::BlockStateBase <Channels, Real>::BlockSize*Channels];
+  };
+
   /*@Internal*/
   Cascade::Storage getCascadeStorage()
   {
@@ -0,0 +1,318 @@
+/*
+ * bd_batch: offline beat analysis of many files.
+ *
+ * Reads a list of audio files (one path per line, "-" for stdin), runs the
+ * onset -> autocorrelation tempo -> beat tracker pipeline on each one and
+ * writes one JSON object per line:
+ *
+ *   {"file":"a.wav","seconds":212.4,"bpm":123.0,"beats":[0.52,1.01,...]}
+ *
+ * Files are scheduled on a ThreadPool. Every thread keeps its own pipeline
+ * per sample rate and reuses it for all files it gets, so nothing is
+ * allocated per file apart from the decode buffer.
+ */
+
+#include "AutocorrelationModule.h"
+#include "BeatTrackerModule.h"
+#include "OnsetModule.h"
+#include "ThreadPool.h"
+
+#include <sndfile.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+using namespace libsch;
+using namespace std;
+
+
+namespace
+{
+    const size_t BlockLength = 2048;
+    const size_t FftLength = 1024;
+    const size_t Hop = 512;
+
+    //! Ellis' log-Gaussian tempo preference, centre and width in octaves.
+    const double PreferredBpm = 120.0;
+    const double PreferenceOctaves = 1.0;
+
+
+    /*
+     * One analysis chain. The onset module is the head, the tempo and beat
+     * modules both read its output and are owned by it.
+     */
+    struct Pipeline
+    {
+        double onsetRate;
+        OnsetModule onset;
+        AutocorrelationModule &tempo;
+        BeatTrackerModule &beats;
+
+        explicit Pipeline(unsigned int sampleRate)
+            : onsetRate(static_cast<double>(sampleRate)/Hop)
+            , onset(BlockLength, "onset", 0, FftLength, Hop)
+            , tempo(*new AutocorrelationModule(BlockLength/Hop, onsetRate, "tempo", &onset))
+            , beats(*new BeatTrackerModule(BlockLength/Hop, onsetRate, "beats", &onset,
+                                           PreferredBpm))
+        { }
+
+        //! Forget the previous file, including its tempo, so results do not
+        //! depend on which file this worker analysed before.
+        void Reset()
+        {
+            onset.Reset();
+            tempo.Reset();
+            beats.SetBpm(PreferredBpm);
+            beats.Reset();
+        }
+
+        //! Strongest lag after weighting with the tempo preference.
+        double PreferredTempo() const
+        {
+            double best = PreferredBpm, bestScore = 0;
+            for (size_t k = 0; k < tempo.OutDataLength(); ++k)
+            {
+                double bpm = tempo.Bpm(k);
+                double oct = log2(bpm/PreferredBpm)/PreferenceOctaves;
+                double score = tempo.OutVec()[k]*exp(-0.5*oct*oct);
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = bpm;
+                }
+            }
+            return best;
+        }
+    };
+
+    struct Result
+    {
+        bool ok;
+        double seconds;
+        double bpm;
+        vector<double> beats;
+    };
+
+    thread_local map<unsigned int, unique_ptr<Pipeline> > t_pipelines;
+
+    Pipeline& pipelineFor(unsigned int sampleRate)
+    {
+        unique_ptr<Pipeline> &p = t_pipelines[sampleRate];
+        if (!p) p.reset(new Pipeline(sampleRate));
+        p->Reset();
+        return *p;
+    }
+
+    void runBlock(Pipeline &p, Result &r, size_t &blocks)
+    {
+        p.onset.Update(Frame());
+        for (double t : p.beats.LastBeats()) r.beats.push_back(t);
+
+        // Follow the tempo once the autocorrelation window is filled.
+        if (++blocks*p.tempo.InDataLength() >= p.tempo.WindowLength())
+        {
+            p.beats.SetBpm(p.PreferredTempo());
+        }
+    }
+
+    Result analyse(const string &path)
+    {
+        Result r;
+        r.ok = false;
+        r.seconds = 0;
+        r.bpm = 0;
+
+        SF_INFO info;
+        memset(&info, 0, sizeof(info));
+        SNDFILE *sf = sf_open(path.c_str(), SFM_READ, &info);
+        if (NULL == sf) return r;
+
+        Pipeline &p = pipelineFor(info.samplerate);
+        const size_t ch = info.channels;
+        vector<float> pcm(BlockLength*ch);
+        const float scale = 1.0f/ch;
+        size_t blocks = 0;
+
+        sf_count_t got;
+        while ((got = sf_readf_float(sf, &pcm[0], BlockLength)) > 0)
+        {
+            // Mono downmix straight into the head's input.
+            float *in = p.onset.InVec();
+            for (sf_count_t i = 0; i < got; ++i)
+            {
+                float s = 0;
+                for (size_t c = 0; c < ch; ++c) s += pcm[i*ch + c];
+                in[i] = s*scale;
+            }
+            for (size_t i = got; i < BlockLength; ++i) in[i] = 0;
+
+            runBlock(p, r, blocks);
+        }
+        sf_close(sf);
+
+        // Flush the beats still inside the tracker's decision delay.
+        size_t flush = (p.beats.Latency() + p.beats.InDataLength() - 1)/p.beats.InDataLength();
+        for (size_t b = 0; b < flush; ++b)
+        {
+            memset(p.onset.InVec(), 0, BlockLength*sizeof(float));
+            runBlock(p, r, blocks);
+        }
+
+        r.seconds = static_cast<double>(info.frames)/info.samplerate;
+        while (!r.beats.empty() && r.beats.back() > r.seconds) r.beats.pop_back();
+        r.bpm = p.beats.Bpm();
+        r.ok = true;
+        return r;
+    }
+
+    string jsonEscape(const string &s)
+    {
+        string o;
+        for (char c : s)
+        {
+            switch (c)
+            {
+            case '"':  o += "\\\""; break;
+            case '\\': o += "\\\\"; break;
+            case '\n': o += "\\n";  break;
+            case '\t': o += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    o += buf;
+                } else {
+                    o += c;
+                }
+            }
+        }
+        return o;
+    }
+
+    string toJson(const string &path, const Result &r)
+    {
+        ostringstream os;
+        os.setf(ios::fixed);
+        os.precision(3);
+        os << "{\"file\":\"" << jsonEscape(path) << "\"";
+        if (!r.ok)
+        {
+            os << ",\"error\":\"cannot open\"}";
+            return os.str();
+        }
+        os << ",\"seconds\":" << r.seconds;
+        os.precision(2);
+        os << ",\"bpm\":" << r.bpm;
+        os.precision(3);
+        os << ",\"beats\":[";
+        for (size_t i = 0; i < r.beats.size(); ++i)
+        {
+            if (i) os << ',';
+            os << r.beats[i];
+        }
+        os << "]}";
+        return os.str();
+    }
+}
+
+
+void usage()
+{
+    cerr << "Usage: bdbatch [-j threads] [-o out.jsonl] <file-list | ->\n"
+            "  Writes one JSON line per file to out.jsonl (default stdout),\n"
+            "  the summary goes to stderr." << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int threads = 0;
+    string outName;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:o:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'j': threads = static_cast<unsigned int>(atoi(optarg)); break;
+        case 'o': outName = optarg; break;
+        default:  usage(); return 1;
+        }
+    }
+    if (optind >= argc)
+    {
+        usage();
+        return 1;
+    }
+
+    vector<string> files;
+    {
+        string listName(argv[optind]);
+        ifstream listFile;
+        if (listName != "-") listFile.open(listName.c_str());
+        istream &list = (listName == "-") ? cin : listFile;
+        if (!list)
+        {
+            cerr << "Cannot read " << listName << endl;
+            return 1;
+        }
+        string line;
+        while (getline(list, line))
+        {
+            if (!line.empty()) files.push_back(line);
+        }
+    }
+
+    ofstream outFile;
+    if (!outName.empty()) outFile.open(outName.c_str());
+    ostream &out = outName.empty() ? cout : outFile;
+
+    mutex outLock;
+    atomic<size_t> failed(0);
+    double audioSeconds = 0;
+
+    auto start = chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        cerr << files.size() << " files, " << pool.NumThreads() << " threads" << endl;
+
+        for (const string &f : files)
+        {
+            pool.Submit([&, f]() {
+                Result r = analyse(f);
+                string line = toJson(f, r);
+                lock_guard<mutex> lk(outLock);
+                out << line << '\n';
+                if (r.ok) audioSeconds += r.seconds;
+                else ++failed;
+            });
+        }
+        pool.Wait();
+    }
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    out.flush();
+
+    size_t done = files.size() - failed.load();
+    cerr.setf(ios::fixed);
+    cerr.precision(2);
+    cerr << done << " files analysed, " << failed.load() << " failed, "
+         << audioSeconds << " s of audio in " << wall << " s: "
+         << (wall > 0 ? done/wall : 0) << " files/s, realtime factor "
+         << (wall > 0 ? audioSeconds/wall : 0) << "x" << endl;
+
+    return failed.load() == 0 ? 0 : 2;
+}
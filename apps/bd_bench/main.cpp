@@ -0,0 +1,198 @@
+/*
+ * bd_bench: per kernel timing of the dispatched ICST kernels.
+ *
+ * Runs every kernel that has SSE2, AVX2 and AVX-512 versions once per
+ * instruction set the CPU supports (BlkDsp::LimitCpuIsa) and prints the
+ * time per call and the gain over SSE2:
+ *
+ *   kernel       sse2 ns   avx2 ns avx512 ns    avx2 x  avx512 x
+ *   mac          612.4     398.0     251.7      1.54      2.43
+ *
+ * fsqrt includes an abs of its input, so compare it against the abs row.
+ * The library is built for SSE2 with the wider versions selected at run
+ * time, so the numbers show what a generic build gains on this machine.
+ */
+
+#include "Common.h"
+#include "BlkDsp.h"
+#include "AudioAnalysis.h"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+
+using namespace icstdsp;
+using namespace std;
+
+
+namespace
+{
+    const char *IsaNames[] = { "sse2", "avx2", "avx512" };
+    const int NumIsa = 3;
+
+    volatile float sink;
+
+    /*
+     * Buffers shared by all kernels. Each kernel starts from the same input
+     * and leaves its operands in a state where the next call costs the same
+     * (no overflow, no denormals), so nothing is refreshed between calls.
+     */
+    struct Data
+    {
+        int size;
+        float *in;      //!< 2*size values in [-1,1).
+        float *d;       //!< In/out, reset from in before each kernel.
+        float *r;       //!< Second operand, 2*size values in [-1,1).
+        float *zeros;   //!< 2*size zeros, keeps add stationary.
+        float *ones;    //!< 2*size ones, keeps mul stationary.
+        float *cones;   //!< size complex ones, keeps cpxmul stationary.
+        vector<float> envState, attack, release;
+
+        Data(int n, int offset)
+            : size(n), envState(16, 0.0f), attack(16, 10.0f), release(16, 1000.0f)
+        {
+            in = alloc(2*n, offset);
+            d = alloc(2*n, offset);
+            r = alloc(2*n, offset);
+            zeros = alloc(2*n, offset);
+            ones = alloc(2*n, offset);
+            cones = alloc(2*n, offset);
+            for (int i = 0; i < 2*n; ++i)
+            {
+                in[i] = 2.0f*rand()/RAND_MAX - 1.0f;
+                r[i] = 2.0f*rand()/RAND_MAX - 1.0f;
+                zeros[i] = 0.0f;
+                ones[i] = 1.0f;
+                cones[i] = (i & 1) ? 0.0f : 1.0f;
+            }
+        }
+
+        //! Buffers live until exit.
+        static float *alloc(int n, int offset)
+        {
+            return BlkDsp::sseallocf(n + 16) + offset;
+        }
+    };
+
+    struct Kernel
+    {
+        string name;
+        function<void(Data &)> run;
+    };
+
+    vector<Kernel> benchKernels()
+    {
+        cpx zero; zero.re = 0.0f; zero.im = 0.0f;
+        return vector<Kernel> {
+            { "add",      [](Data &x) { BlkDsp::add(x.d, x.zeros, x.size); } },
+            { "mul",      [](Data &x) { BlkDsp::mul(x.d, x.ones, x.size); } },
+            { "mac",      [](Data &x) { BlkDsp::mac(x.d, x.r, 0.0f, x.size); } },
+            { "dotp",     [](Data &x) { sink = BlkDsp::dotp(x.d, x.r, x.size); } },
+            { "sdist",    [](Data &x) { sink = BlkDsp::sdist(x.d, x.r, x.size); } },
+            { "energy",   [](Data &x) { sink = BlkDsp::energy(x.d, x.size); } },
+            { "abs",      [](Data &x) { BlkDsp::abs(x.d, x.size); } },
+            { "fsqrt",    [](Data &x) { BlkDsp::abs(x.d, x.size); BlkDsp::fsqrt(x.d, x.size); } },
+            { "logabs",   [](Data &x) { BlkDsp::logabs(x.d, x.size); } },
+            { "cpxmul",   [](Data &x) { BlkDsp::cpxmul(x.d, x.cones, x.size); } },
+            { "cpxmac",   [zero](Data &x) { BlkDsp::cpxmac(x.d, x.r, zero, x.size); } },
+            { "cpxmacv",  [](Data &x) { BlkDsp::cpxmac(x.d, x.r, x.zeros, x.size); } },
+            { "cpxpow",   [](Data &x) { BlkDsp::cpxpow(x.d, x.r, x.size); } },
+            { "cpxmag",   [](Data &x) { BlkDsp::cpxmag(x.d, x.r, x.size); } },
+            { "hann",     [](Data &x) { BlkDsp::hann(x.d, x.size); } },
+            { "envelope", [](Data &x) {
+                AudioAnalysis::envelope(x.r, x.d, &x.envState[0], x.size/16, 16,
+                                        &x.attack[0], &x.release[0], 0); } },
+        };
+    }
+
+    //! Nanoseconds per call, repeating until at least minSeconds elapsed.
+    double timeKernel(const Kernel &k, Data &x, double minSeconds)
+    {
+        BlkDsp::copy(x.d, x.in, 2*x.size);
+        for (int i = 0; i < 10; ++i) k.run(x);
+        long calls = 16;
+        while (true)
+        {
+            auto start = chrono::steady_clock::now();
+            for (long i = 0; i < calls; ++i) k.run(x);
+            double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (t >= minSeconds) return 1e9*t/calls;
+            calls *= 2;
+        }
+    }
+}
+
+
+void usage()
+{
+    cerr << "Usage: bdbench [-n size] [-t seconds] [-u]\n"
+            "  -n  samples per call (default 4096)\n"
+            "  -t  minimum time per kernel and instruction set (default 0.2)\n"
+            "  -u  use buffers that are not 16 byte aligned" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int size = 4096;
+    double minSeconds = 0.2;
+    int offset = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:uh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': size = atoi(optarg); break;
+        case 't': minSeconds = atof(optarg); break;
+        case 'u': offset = 1; break;
+        default:  usage(); return 1;
+        }
+    }
+    if (size < 16)
+    {
+        usage();
+        return 1;
+    }
+
+    // levels the CPU supports, the environment (ICSTDSP_ISA) may cap them
+    vector<int> isas;
+    for (int isa = 0; isa < NumIsa; ++isa)
+    {
+        if (BlkDsp::LimitCpuIsa(isa) == isa) isas.push_back(isa);
+    }
+
+    Data x(size, offset);
+    vector<Kernel> ks = benchKernels();
+
+    cout << "n = " << size << (offset ? ", unaligned" : "") << '\n';
+    cout << left << setw(10) << "kernel" << right;
+    for (int isa : isas) cout << setw(10) << (string(IsaNames[isa]) + " ns");
+    for (size_t i = 1; i < isas.size(); ++i) cout << setw(10) << (string(IsaNames[isas[i]]) + " x");
+    cout << '\n';
+
+    cout.setf(ios::fixed);
+    for (const Kernel &k : ks)
+    {
+        vector<double> ns;
+        for (int isa : isas)
+        {
+            BlkDsp::LimitCpuIsa(isa);
+            ns.push_back(timeKernel(k, x, minSeconds));
+        }
+        cout << left << setw(10) << k.name << right << setprecision(1);
+        for (double t : ns) cout << setw(10) << t;
+        cout << setprecision(2);
+        for (size_t i = 1; i < ns.size(); ++i) cout << setw(10) << ns[0]/ns[i];
+        cout << endl;
+    }
+
+    BlkDsp::LimitCpuIsa(NumIsa - 1);
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "AutocorrelationModule.h"
+#include "BufferPool.h"
+#include "Common.h"
+#include "BlkDsp.h"
+
+#include <algorithm>
+
+
+namespace libsch{
+
+AutocorrelationModule::AutocorrelationModule(size_t datalength, double onsetRate,
+                                             const std::string &id, BaseModule *parent,
+                                             double windowSeconds, double minLagSeconds,
+                                             double maxLagSeconds)
+    : BaseModule(id, parent)
+    , m_dataLength(datalength)
+    , m_onsetRate(onsetRate)
+    , m_slot(0)
+    , m_sinceRebuild(0)
+    , m_history(NULL)
+{
+    m_minLag = std::max<size_t>(1, static_cast<size_t>(minLagSeconds*onsetRate + 0.5));
+    m_maxLag = std::max(m_minLag, static_cast<size_t>(maxLagSeconds*onsetRate + 0.5));
+    m_numSums = 1 + m_maxLag - m_minLag + 1;
+
+    size_t window = static_cast<size_t>(windowSeconds*onsetRate + 0.5);
+    m_numBlocks = std::max<size_t>(1, (window + datalength-1)/datalength);
+
+    dbg_prt((std::string(__func__) + ": lags " + std::to_string(m_minLag) + ".." +
+                std::to_string(m_maxLag) + ", window " +
+                std::to_string(m_numBlocks*datalength) + " samples").c_str());
+
+    InDataLength(datalength);
+    OutDataLength(m_maxLag - m_minLag + 1);
+
+    m_history = BufferPool::Instance().Acquire(m_maxLag + datalength);
+    m_partials.resize(m_numBlocks*m_numSums);
+    m_totals.resize(m_numSums);
+    m_block.resize(m_numSums);
+
+    Reset();
+}
+
+AutocorrelationModule::~AutocorrelationModule(void)
+{
+    BufferPool::Instance().Release(m_history);
+}
+
+size_t AutocorrelationModule::MinLag() const
+{
+    return m_minLag;
+}
+
+size_t AutocorrelationModule::MaxLag() const
+{
+    return m_maxLag;
+}
+
+size_t AutocorrelationModule::WindowLength() const
+{
+    return m_numBlocks*m_dataLength;
+}
+
+double AutocorrelationModule::Bpm(size_t k) const
+{
+    return 60.0*m_onsetRate/(m_minLag + k);
+}
+
+double AutocorrelationModule::BestBpm() const
+{
+    size_t best = std::max_element(_outvec, _outvec + _outLength) - _outvec;
+    return Bpm(best);
+}
+
+void AutocorrelationModule::Reset()
+{
+    memset(m_history, 0, (m_maxLag + m_dataLength)*sizeof(float));
+    std::fill(m_partials.begin(), m_partials.end(), 0.0);
+    std::fill(m_totals.begin(), m_totals.end(), 0.0);
+    m_slot = 0;
+    m_sinceRebuild = 0;
+}
+
+/*
+ * Partial sum of lag l over the block is the dot product of the block with
+ * the history l samples earlier. Partials are kept in double so that
+ * subtracting an expired block cancels exactly what was added.
+ */
+void AutocorrelationModule::DoUpdate()
+{
+    const size_t dl = m_dataLength;
+    const int n = static_cast<int>(dl);
+    float *cur = m_history + m_maxLag;
+
+    memcpy(cur, _invec, dl*sizeof(float));
+
+    m_block[0] = icstdsp::BlkDsp::dotp(cur, cur, n);
+    for (size_t l = m_minLag; l <= m_maxLag; ++l)
+    {
+        m_block[1 + l - m_minLag] = icstdsp::BlkDsp::dotp(cur, cur - l, n);
+    }
+
+    double *row = &m_partials[m_slot*m_numSums];
+    if (++m_sinceRebuild >= m_numBlocks)
+    {
+        // Once per window: totals from the stored partials, drift free.
+        for (size_t k = 0; k < m_numSums; ++k) row[k] = m_block[k];
+        std::fill(m_totals.begin(), m_totals.end(), 0.0);
+        for (size_t b = 0; b < m_numBlocks; ++b)
+        {
+            const double *p = &m_partials[b*m_numSums];
+            for (size_t k = 0; k < m_numSums; ++k) m_totals[k] += p[k];
+        }
+        m_sinceRebuild = 0;
+    }
+    else
+    {
+        for (size_t k = 0; k < m_numSums; ++k)
+        {
+            m_totals[k] += m_block[k] - row[k];
+            row[k] = m_block[k];
+        }
+    }
+    if (++m_slot == m_numBlocks) m_slot = 0;
+
+    double norm = (m_totals[0] > 0) ? 1.0/m_totals[0] : 0.0;
+    for (size_t k = 0; k < _outLength; ++k)
+    {
+        _outvec[k] = static_cast<float>(m_totals[1 + k]*norm);
+    }
+
+    memmove(m_history, m_history + dl, m_maxLag*sizeof(float));
+}
+
+
+} /*namespace libsch*/
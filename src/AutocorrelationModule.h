@@ -0,0 +1,94 @@
+#ifndef AUTOCORRELATIONMODULE_H_
+#define AUTOCORRELATIONMODULE_H_
+
+#include "Export.h"
+#include "BaseModule.h"
+
+#include <vector>
+
+namespace libsch
+{
+    /*!
+     * \class   AutocorrelationModule AutocorrelationModule.h
+     * \brief   Sliding autocorrelation of an onset signal over a tempo lag
+     *          range, updated block by block.
+     *
+     *          The input is \c datalength onset values per block (e.g. the
+     *          output of an OnsetModule) at \c onsetRate Hz. After every
+     *          block the output holds, for every lag l from MinLag() to
+     *          MaxLag(),
+     *                 r[l] = sum x[n]*x[n-l] / sum x[n]^2
+     *          with n running over the last WindowLength() input samples
+     *          (x[n-l] may be older than the window). Lag MinLag()+k is
+     *          tempo Bpm(k).
+     *
+     *          Instead of a full FFT autocorrelation of the window every
+     *          hop, the window is split into blocks. Each new block adds its
+     *          partial sums, one SIMD dot product per lag (O(lags*datalength)),
+     *          and the partials of the block that leaves the window are
+     *          subtracted. The running totals are rebuilt from the stored
+     *          partials once per window length, so rounding errors cannot
+     *          accumulate.
+     */
+    class DllExport AutocorrelationModule : public BaseModule
+    {
+
+    public:
+        /*!
+         * \param datalength    Onset values per block.
+         * \param onsetRate     Onset values per second.
+         * \param id
+         * \param parent
+         * \param windowSeconds Analysis window, rounded up to whole blocks.
+         * \param minLagSeconds Shortest lag, i.e. fastest tempo.
+         * \param maxLagSeconds Longest lag, i.e. slowest tempo.
+         */
+        AutocorrelationModule(size_t datalength, double onsetRate,
+                              const std::string &id, BaseModule *parent=0,
+                              double windowSeconds=8.0, double minLagSeconds=0.25,
+                              double maxLagSeconds=2.0);
+        ~AutocorrelationModule(void);
+
+        size_t MinLag() const;
+        size_t MaxLag() const;
+
+        //! Input samples the sums run over.
+        size_t WindowLength() const;
+
+        //! Tempo of output \c k in beats per minute.
+        double Bpm(size_t k) const;
+
+        //! Tempo of the strongest lag after the last block.
+        double BestBpm() const;
+
+        //! Clear the history and all sums.
+        void Reset();
+
+    protected:
+        virtual void DoUpdate() override;
+
+    private:
+        size_t m_dataLength;
+        double m_onsetRate;
+        size_t m_minLag;
+        size_t m_maxLag;
+        //! Lags 0 and MinLag()..MaxLag().
+        size_t m_numSums;
+
+        //! Blocks in the window.
+        size_t m_numBlocks;
+        //! Next partial to overwrite, counts blocks until the next rebuild.
+        size_t m_slot;
+        size_t m_sinceRebuild;
+
+        //! Last MaxLag() inputs followed by the current block.
+        float *m_history;
+        //! m_numBlocks rows of m_numSums partial sums.
+        std::vector<double> m_partials;
+        std::vector<double> m_totals;
+        //! Partials of the current block.
+        std::vector<float> m_block;
+    };
+
+}
+#endif /* AUTOCORRELATIONMODULE_H_ */
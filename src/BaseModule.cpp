@@ -63,8 +63,6 @@ BaseModule::~BaseModule()
 	{
 		delete *it;
 	}
-	if (NULL != _invec)  delete [] _invec;
-	if (NULL != _outvec) delete [] _outvec;
 }
 
 
@@ -139,7 +137,7 @@ const std::string& BaseModule::Id() const
     return id;
 }
 
-//!reallocate memory
+//!resize the input buffer, storage comes from the aligned BufferPool
 SCH_RESULT BaseModule::InDataLength(size_t inSz)
 {
 
@@ -148,21 +146,19 @@ SCH_RESULT BaseModule::InDataLength(size_t inSz)
 
     SCH_RESULT rval = SCH_OK;
 
-	if (NULL == _invec)
-	{
-		_invec = new realval_t[inSz];
-	}
-	else
-	{
-		delete [] _invec;
-		_invec = new realval_t[inSz];
-	}
+    // Keep the current storage when the size does not change.
+    if (m_inStore.Length() != inSz)
+    {
+        m_inStore.Reset();
+        m_inStore = Frame(inSz);
+    }
+    _invec = m_inStore.MutableData();
     memset(_invec,0,inSz*sizeof(realval_t));
     _inLength = inSz;
 	return rval;
 }
 
-//!reallocate memory
+//!resize the output frame, storage comes from the aligned BufferPool
 SCH_RESULT BaseModule::OutDataLength(size_t outSz)
 {
 
@@ -171,16 +167,9 @@ SCH_RESULT BaseModule::OutDataLength(size_t outSz)
 
     SCH_RESULT rval = SCH_OK;
 
-	if (NULL == _outvec)
-	{
-		_outvec = new realval_t[outSz];
-	}
-	else
-	{
-		delete [] _outvec;
-		_outvec = new realval_t[outSz];
-	}
-    memset(_outvec,0,outSz*sizeof(realval_t));
+    m_outFrame.Reset();             //hand the old slab back first so it can be reused.
+    m_outFrame = Frame(outSz);      //zeroed, and not shared with anybody.
+    _outvec = m_outFrame.MutableData();
 	_outLength = outSz;
     return rval;
 }
@@ -210,4 +199,98 @@ void BaseModule::Update(realval_t *input)
     //emit UpdateChildren(_outvec);
 }
 
+void BaseModule::UpdateChildren(const Frame &out)
+{
+    for(auto &child : children) {
+        child->Update(out);
+    }
+}
+
+void BaseModule::Update(const Frame &in)
+{
+    dbg_prt(("BaseModule: Update called on module: " + id).c_str());
+
+    Process(in);
+    UpdateChildren(m_outFrame);
+}
+
+void BaseModule::Process(const Frame &in)
+{
+    if (! in.IsNull()) {
+        bindInput(in);
+    }
+
+    // A child from the previous block may still hold our last output (e.g.
+    // when stages run on different threads), never write under it.
+    _outvec = m_outFrame.MutableData();
+
+    DoUpdate();
+
+    releaseInput();
+}
+
+SCH_RESULT BaseModule::SwapOutFrame(Frame &frame)
+{
+    if (frame.Length() != _outLength) {
+        dbg_prt((std::string(__func__) + ": frame length does not match "
+                    "the output length of " + id).c_str());
+        return SCH_ERR_OUTOFBOUNDS;
+    }
+    m_outFrame.Swap(frame);
+    _outvec = const_cast<realval_t*>(m_outFrame.Data());
+    return SCH_OK;
+}
+
+SCH_RESULT BaseModule::SwapInStore(Frame &store)
+{
+    if (store.IsNull() ? NeedsInStore() : store.Length() < _inLength) {
+        dbg_prt((std::string(__func__) + ": store too small for the input of " + id).c_str());
+        return SCH_ERR_OUTOFBOUNDS;
+    }
+    m_inStore.Swap(store);
+    _invec = m_inStore.MutableData();
+    return SCH_OK;
+}
+
+bool BaseModule::NeedsInStore() const
+{
+    return NULL == parent || ModifiesInput() || parent->OutDataLength() < _inLength;
+}
+
+bool BaseModule::ModifiesInput() const
+{
+    return false;
+}
+
+bool BaseModule::InPlace() const
+{
+    return false;
+}
+
+/**
+ *  Point _invec at the samples in \c in, or copy them into this module's own
+ *  storage if this module writes to its input or expects more samples than
+ *  the frame holds.
+ */
+void BaseModule::bindInput(const Frame &in)
+{
+    if (! ModifiesInput() && in.Length() >= _inLength) {
+        m_inFrame = in;
+        _invec = const_cast<realval_t*>(m_inFrame.Data());
+    } else {
+        size_t n = in.Length() < _inLength ? in.Length() : _inLength;
+        _invec = m_inStore.MutableData();
+        memcpy(_invec, in.Data(), n*sizeof(realval_t));
+    }
+}
+
+//! Let go of the parent's frame so the parent can reuse it for the next block.
+void BaseModule::releaseInput()
+{
+    if (! m_inFrame.IsNull()) {
+        m_inFrame.Reset();
+        _invec = m_inStore.MutableData();
+    }
+}
+
 }; /* namespace libsch */
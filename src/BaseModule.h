@@ -5,6 +5,7 @@
 
 #include "BdTypes.h"
 #include "Export.h"
+#include "Frame.h"
 #include "prt_dbg.h"
 
 #include <iostream>
@@ -37,10 +38,14 @@ namespace libsch {
     ----------             ---------
     | PARENT | ----------> | CHILD |
     ----------             ---------
-    &_outvec               &_invec
+    OutFrame()             &_invec
     ----------------------------------
 
-    The contents of the parent's _outvec are memcpy'ed to _invec.
+    The parent publishes its _outvec once as a reference counted Frame and
+    every child reads that Frame directly: _invec points into the parent's
+    storage for the duration of DoUpdate(), no copy is made. Modules that
+    write to _invec must say so by overriding ModifiesInput(); they get a
+    private copy in their own _invec instead (copy-on-write).
     There could be many children for 1 parent, but each child may have
     only 1 parent.
 
@@ -152,6 +157,23 @@ namespace libsch {
 		*/
 		inline realval_t* InVec() const;
 		inline realval_t* OutVec() const;
+
+        /*!
+        * \brief The Frame holding this module's output, as published to
+        *        its children by the last Update().
+        */
+        inline const Frame& OutFrame() const;
+
+        /*!
+        * \brief Exchange the Frame behind _outvec with \c frame.
+        *
+        * Lets an executor hand this module preallocated output storage for
+        * the next Process() and take the filled one back afterwards.
+        *
+        * \return SCH_ERR_OUTOFBOUNDS if \c frame is not OutDataLength()
+        *         samples long, nothing is swapped then.
+        */
+        SCH_RESULT SwapOutFrame(Frame &frame);
 		
 		/*!
 		 *  \brief Sets the length of the buffer(s) for this module, and allocates
@@ -202,6 +224,11 @@ namespace libsch {
 
         void UpdateChildren(realval_t *);
 
+        /*!
+        * \brief Hand \c out to every child without copying it.
+        */
+        void UpdateChildren(const Frame &out);
+
         /*!
         * \brief Called when this module should update it's children. 
         * 
@@ -215,6 +242,67 @@ namespace libsch {
         */
         virtual void Update(realval_t *in);
 
+        /*!
+        * \brief Zero-copy update: process \c in, then hand OutFrame() to
+        *        every child.
+        *
+        * \c in is read in place unless ModifiesInput() is true or \c in is
+        * shorter than this module's input length, in which case it is copied
+        * into _invec first. A null \c in leaves _invec as it is, which is
+        * what the pipeline head wants.
+        *
+        * \param in The parent's published output.
+        */
+        void Update(const Frame &in);
+
+        /*!
+        * \brief Run DoUpdate() on \c in for this module only, without
+        *        signalling the children.
+        *
+        * Update(const Frame &) is Process() followed by UpdateChildren().
+        * Executors that schedule the children themselves call this.
+        */
+        void Process(const Frame &in);
+
+        /*!
+        * \brief Does DoUpdate() write to _invec?
+        *
+        * Modules that return false (the default) read their parent's
+        * output in place. Override and return true if DoUpdate() modifies
+        * _invec; the input is then copied before DoUpdate() runs.
+        */
+        virtual bool ModifiesInput() const;
+
+        /*!
+        * \brief May _outvec be the same array as _invec?
+        *
+        * Return true if DoUpdate() never reads _invec[j] after writing
+        * _outvec[i] for some i <= j, e.g. a plain element-wise map. A
+        * GraphPlanner may then let this module overwrite its parent's
+        * output. Defaults to false.
+        */
+        virtual bool InPlace() const;
+
+        /*!
+        * \brief Does Process() copy the input into this module's own store?
+        *
+        * True for the pipeline head, for modules that ModifiesInput() and
+        * when the parent's output is shorter than InDataLength(). Otherwise
+        * the parent's frame is read in place and the store is unused.
+        */
+        bool NeedsInStore() const;
+
+        /*!
+        * \brief Exchange this module's input store with \c store.
+        *
+        * \c store must hold at least InDataLength() samples. A null frame
+        * drops the store, which is only allowed when !NeedsInStore().
+        *
+        * \return SCH_ERR_OUTOFBOUNDS if \c store is not usable, nothing is
+        *         swapped then.
+        */
+        SCH_RESULT SwapInStore(Frame &store);
+
     protected:
         /*!
         *  Pointer to one and only parent for this module.
@@ -227,7 +315,15 @@ namespace libsch {
         BaseModuleVector      children;
         std::string  id;
 
+        /*!
+        *  Input samples for DoUpdate(). Either this module's own storage or,
+        *  during DoUpdate(), a read-only view of the parent's OutFrame().
+        */
 		realval_t    *_invec;
+
+        /*!
+        *  Output samples written by DoUpdate(). Points into m_outFrame.
+        */
 		realval_t    *_outvec;
 
         /*!
@@ -249,6 +345,20 @@ namespace libsch {
         */
         virtual void DoUpdate() = 0;
 
+    private:
+        //! This module's own input storage, _invec points here when not
+        //! reading the parent's frame in place.
+        Frame         m_inStore;
+
+        //! Keeps the parent's frame alive while _invec points into it.
+        Frame         m_inFrame;
+
+        //! Storage behind _outvec.
+        Frame         m_outFrame;
+
+        void bindInput(const Frame &in);
+        void releaseInput();
+
     
 }; /* BaseModule */
 
@@ -268,6 +378,11 @@ namespace libsch {
 		return _outvec;
 	}
 
+    inline const Frame& BaseModule::OutFrame() const
+    {
+        return m_outFrame;
+    }
+
     inline size_t BaseModule::InDataLength() const
 	{
 		return _inLength;
@@ -0,0 +1,171 @@
+#include "BeatTrackerModule.h"
+#include "Common.h"
+
+#include <algorithm>
+#include <math.h>
+
+
+namespace libsch{
+
+namespace
+{
+    //! Onset normalization time constant in seconds.
+    const double RmsSeconds = 3.0;
+
+    const uint64_t NoLink = ~static_cast<uint64_t>(0);
+}
+
+
+BeatTrackerModule::BeatTrackerModule(size_t datalength, double onsetRate,
+                                     const std::string &id, BaseModule *parent,
+                                     double bpm, float tightness,
+                                     double latencySeconds, double minBpm)
+    : BaseModule(datalength, datalength, id, parent)
+    , m_dataLength(datalength)
+    , m_onsetRate(onsetRate)
+    , m_tightness(tightness)
+    , m_bpm(0)
+    , m_period(0)
+    , m_dMin(0)
+    , m_dMax(0)
+    , m_mask(0)
+{
+    m_maxPeriod = std::max<size_t>(2, static_cast<size_t>(60.0*onsetRate/minBpm + 0.5));
+    m_latency = static_cast<size_t>(latencySeconds*onsetRate + 0.5);
+
+    // Scores are read back 2P, backlinks back to the latency horizon.
+    size_t span = m_latency + 2*m_maxPeriod + 1;
+    size_t size = 1;
+    while (size < span) size <<= 1;
+    m_mask = size - 1;
+
+    m_score.resize(size);
+    m_link.resize(size);
+    m_penalty.resize(2*m_maxPeriod + 1);
+    m_lastBeats.reserve(datalength);
+    m_rmsCoef = static_cast<float>(1.0 - exp(-1.0/(RmsSeconds*onsetRate)));
+
+    SetBpm(bpm);
+    Reset();
+}
+
+BeatTrackerModule::~BeatTrackerModule(void)
+{
+}
+
+void BeatTrackerModule::SetBpm(double bpm)
+{
+    double maxBpm = 30.0*m_onsetRate;
+    double minBpm = 60.0*m_onsetRate/m_maxPeriod;
+    m_bpm = std::min(std::max(bpm, minBpm), maxBpm);
+
+    double P = 60.0*m_onsetRate/m_bpm;
+    m_period = std::max<size_t>(1, static_cast<size_t>(P + 0.5));
+    m_dMin = std::max<size_t>(1, static_cast<size_t>(P/2 + 0.5));
+    m_dMax = std::min(2*m_maxPeriod, static_cast<size_t>(2*P + 0.5));
+    for (size_t d = m_dMin; d <= m_dMax; ++d)
+    {
+        double l = log(d/P);
+        m_penalty[d] = static_cast<float>(-m_tightness*l*l);
+    }
+}
+
+double BeatTrackerModule::Bpm() const
+{
+    return m_bpm;
+}
+
+size_t BeatTrackerModule::Latency() const
+{
+    return m_latency;
+}
+
+const std::vector<double>& BeatTrackerModule::LastBeats() const
+{
+    return m_lastBeats;
+}
+
+uint64_t BeatTrackerModule::BeatCount() const
+{
+    return m_beatCount;
+}
+
+void BeatTrackerModule::Reset()
+{
+    std::fill(m_score.begin(), m_score.end(), 0.0f);
+    std::fill(m_link.begin(), m_link.end(), NoLink);
+    m_frame = 0;
+    m_lastBeat = 0;
+    m_haveBeat = false;
+    m_beatCount = 0;
+    m_meanSquare = 0;
+    m_lastBeats.clear();
+}
+
+/*
+ * One DP step for frame m_frame, then the decision for frame
+ * m_frame - Latency(). Both loops are bounded by the tempo range.
+ */
+void BeatTrackerModule::step(float onset, float *out)
+{
+    const uint64_t t = m_frame;
+
+    m_meanSquare += m_rmsCoef*(onset*onset - m_meanSquare);
+    float o = onset/(sqrtf(m_meanSquare) + 1e-9f);
+
+    float best = 0;
+    uint64_t link = NoLink;
+    size_t dMax = static_cast<size_t>(std::min<uint64_t>(m_dMax, t));
+    for (size_t d = m_dMin; d <= dMax; ++d)
+    {
+        float v = m_score[(t - d) & m_mask] + m_penalty[d];
+        if (link == NoLink || v > best)
+        {
+            best = v;
+            link = t - d;
+        }
+    }
+    m_score[t & m_mask] = o + best;
+    m_link[t & m_mask] = link;
+
+    *out = 0;
+    if (t >= m_latency)
+    {
+        const uint64_t decide = t - m_latency;
+
+        // Best end point within the last period.
+        uint64_t s = t;
+        for (uint64_t u = t; u + m_period > t && u > decide; --u)
+        {
+            if (m_score[u & m_mask] > m_score[s & m_mask]) s = u;
+        }
+
+        while (s != NoLink && s > decide)
+        {
+            s = m_link[s & m_mask];
+        }
+
+        if (s == decide && (!m_haveBeat || decide - m_lastBeat >= m_dMin))
+        {
+            m_lastBeat = decide;
+            m_haveBeat = true;
+            ++m_beatCount;
+            m_lastBeats.push_back(decide/m_onsetRate);
+            *out = 1.0f;
+        }
+    }
+
+    ++m_frame;
+}
+
+void BeatTrackerModule::DoUpdate()
+{
+    m_lastBeats.clear();
+    for (size_t j = 0; j < m_dataLength; ++j)
+    {
+        step(_invec[j], _outvec + j);
+    }
+}
+
+
+} /*namespace libsch*/
@@ -0,0 +1,112 @@
+#ifndef BEATTRACKERMODULE_H_
+#define BEATTRACKERMODULE_H_
+
+#include "Export.h"
+#include "BaseModule.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace libsch
+{
+    /*!
+     * \class   BeatTrackerModule BeatTrackerModule.h
+     * \brief   Causal dynamic programming beat tracker after Ellis.
+     *
+     *          The input is \c datalength onset strength values per block at
+     *          \c onsetRate Hz (e.g. from an OnsetModule); the tempo comes
+     *          from SetBpm(), typically fed from AutocorrelationModule or
+     *          ResonatorModule. Onsets are normalized by a running RMS, then
+     *          every frame t gets the cumulative score
+     *              C[t] = O[t] + max_d ( C[t-d] - tightness*log(d/P)^2 )
+     *          over d in [P/2, 2P], P the beat period in frames, and a
+     *          backlink to the best predecessor.
+     *
+     *          Scores and backlinks live in circular buffers sized from
+     *          \c minBpm and \c latencySeconds, so memory and per-frame work
+     *          are bounded by the tempo range and never grow with the stream.
+     *          The penalty term is tabulated whenever the tempo changes.
+     *
+     *          Beats are decided Latency() frames late: every frame the chain
+     *          of backlinks from the best score of the last period is followed
+     *          back to frame t-Latency(), which becomes a beat if the chain
+     *          passes through it. Decisions are final.
+     *
+     *          Output j of a block is 1 if frame (first frame of the block +
+     *          j - Latency()) is a beat, 0 otherwise. The beat times of the
+     *          last block in seconds are also available from LastBeats().
+     */
+    class DllExport BeatTrackerModule : public BaseModule
+    {
+
+    public:
+        /*!
+         * \param datalength        Onset values per block.
+         * \param onsetRate         Onset values per second.
+         * \param id
+         * \param parent
+         * \param bpm               Initial tempo.
+         * \param tightness         Weight of the tempo penalty.
+         * \param latencySeconds    Decision delay, at least one beat period
+         *                          is recommended.
+         * \param minBpm            Slowest tempo SetBpm() will accept.
+         */
+        BeatTrackerModule(size_t datalength, double onsetRate,
+                          const std::string &id, BaseModule *parent=0,
+                          double bpm=120.0, float tightness=100.0f,
+                          double latencySeconds=1.0, double minBpm=40.0);
+        ~BeatTrackerModule(void);
+
+        //! Set the beat period, clamped to [minBpm, onsetRate*30] bpm.
+        void SetBpm(double bpm);
+        double Bpm() const;
+
+        //! Decision delay in frames.
+        size_t Latency() const;
+
+        //! Times in seconds from the stream start of the beats decided by
+        //! the last Update(), in order.
+        const std::vector<double>& LastBeats() const;
+
+        //! Beats decided since construction or Reset().
+        uint64_t BeatCount() const;
+
+        //! Start over with a new stream.
+        void Reset();
+
+    protected:
+        virtual void DoUpdate() override;
+
+    private:
+        size_t m_dataLength;
+        double m_onsetRate;
+        float m_tightness;
+        size_t m_latency;
+        size_t m_maxPeriod;
+
+        double m_bpm;
+        size_t m_period;
+        size_t m_dMin;
+        size_t m_dMax;
+        //! Penalty per predecessor distance, index d.
+        std::vector<float> m_penalty;
+
+        //! Circular score and backlink buffers, m_mask+1 frames.
+        std::vector<float> m_score;
+        std::vector<uint64_t> m_link;
+        size_t m_mask;
+
+        uint64_t m_frame;
+        uint64_t m_lastBeat;
+        bool m_haveBeat;
+        uint64_t m_beatCount;
+        float m_meanSquare;
+        float m_rmsCoef;
+
+        std::vector<double> m_lastBeats;
+
+        void step(float onset, float *out);
+    };
+
+}
+#endif /* BEATTRACKERMODULE_H_ */
@@ -0,0 +1,144 @@
+/*
+ * BufferPool.cpp
+ *
+ *  Aligned, size-classed sample buffers reused across modules.
+ */
+
+#include "BufferPool.h"
+
+#include "Common.h"
+#include "BlkDsp.h"
+
+#include <stdint.h>
+
+
+namespace libsch
+{
+
+
+BufferPool& BufferPool::Instance()
+{
+    static BufferPool pool;
+    return pool;
+}
+
+BufferPool::BufferPool()
+    : m_stats()
+{ }
+
+BufferPool::~BufferPool()
+{
+    Trim();
+}
+
+realval_t* BufferPool::Acquire(size_t length)
+{
+    unsigned int cls = sizeClass(length);
+    size_t bytes = (size_t(1) << cls) * sizeof(realval_t);
+    realval_t *buf = NULL;
+
+    {
+        std::lock_guard<std::mutex> lk(m_lock);
+        m_stats.acquires++;
+        m_stats.bytesInUse += bytes;
+        if (m_stats.bytesInUse > m_stats.peakBytesInUse) {
+            m_stats.peakBytesInUse = m_stats.bytesInUse;
+        }
+
+        if (! m_free[cls].empty()) {
+            buf = m_free[cls].back();
+            m_free[cls].pop_back();
+            m_stats.reuses++;
+            m_stats.bytesCached -= bytes;
+        }
+    }
+
+    if (NULL == buf) {
+        buf = allocSlab(cls);
+    }
+    return buf;
+}
+
+void BufferPool::Release(realval_t *buf)
+{
+    if (NULL == buf) {
+        return;
+    }
+
+    unsigned int cls = header(buf)->cls;
+    size_t bytes = (size_t(1) << cls) * sizeof(realval_t);
+
+    std::lock_guard<std::mutex> lk(m_lock);
+    m_stats.releases++;
+    m_stats.bytesInUse -= bytes;
+    m_stats.bytesCached += bytes;
+    m_free[cls].push_back(buf);
+}
+
+size_t BufferPool::Capacity(const realval_t *buf)
+{
+    return NULL == buf ? 0 : size_t(1) << header(buf)->cls;
+}
+
+size_t BufferPool::ClassSize(size_t length)
+{
+    return size_t(1) << sizeClass(length);
+}
+
+void BufferPool::Trim()
+{
+    std::lock_guard<std::mutex> lk(m_lock);
+    for (unsigned int c = 0; c < NumClasses; ++c) {
+        for (size_t i = 0; i < m_free[c].size(); ++i) {
+            freeSlab(m_free[c][i]);
+        }
+        m_free[c].clear();
+    }
+    m_stats.bytesCached = 0;
+}
+
+BufferPool::Stats BufferPool::GetStats() const
+{
+    std::lock_guard<std::mutex> lk(m_lock);
+    return m_stats;
+}
+
+unsigned int BufferPool::sizeClass(size_t length)
+{
+    unsigned int cls = MinClass;
+    while ((size_t(1) << cls) < length) {
+        ++cls;
+    }
+    return cls;
+}
+
+BufferPool::Header* BufferPool::header(const realval_t *buf)
+{
+    return reinterpret_cast<Header*>(
+        reinterpret_cast<uintptr_t>(buf) - sizeof(Header));
+}
+
+/*
+ * Over-allocate by two alignment units, then place the buffer on the first
+ * Alignment boundary that leaves room for the Header in front of it.
+ */
+realval_t* BufferPool::allocSlab(unsigned int cls)
+{
+    size_t pad = 2 * Alignment / sizeof(float);
+    float *slab = icstdsp::BlkDsp::sseallocf(static_cast<int>((size_t(1) << cls) + pad));
+
+    uintptr_t p = reinterpret_cast<uintptr_t>(slab) + sizeof(Header);
+    p = (p + Alignment - 1) & ~static_cast<uintptr_t>(Alignment - 1);
+
+    realval_t *buf = reinterpret_cast<realval_t*>(p);
+    header(buf)->slab = slab;
+    header(buf)->cls = cls;
+    return buf;
+}
+
+void BufferPool::freeSlab(realval_t *buf)
+{
+    icstdsp::BlkDsp::ssefree(header(buf)->slab);
+}
+
+}; /* namespace libsch */
@@ -0,0 +1,102 @@
+#ifndef BUFFERPOOL_H_
+#define BUFFERPOOL_H_
+
+#include "BdTypes.h"
+#include "Export.h"
+
+#include <mutex>
+#include <stddef.h>
+#include <vector>
+
+namespace libsch
+{
+    /*!
+    \class  BufferPool BufferPool.h
+
+    \brief  Process wide pool of aligned sample buffers.
+
+    Every buffer starts on a BufferPool::Alignment byte boundary, so the
+    aligned SSE/AVX paths in icstdsp::BlkDsp are always taken. Requests are
+    rounded up to a power-of-two size class and released buffers are kept
+    on a per-class free list, so modules that are created, destroyed or
+    resized reuse each other's storage instead of going back to the heap.
+
+    The slabs come from icstdsp::BlkDsp::sseallocf(). Acquire() and
+    Release() are thread safe.
+    */
+    class DllExport BufferPool
+    {
+    public:
+        //! Byte alignment of every buffer handed out (one cache line).
+        static const size_t Alignment = 64;
+
+        /*!
+        \struct Stats
+        \brief  Allocation counters, see GetStats().
+        */
+        struct Stats
+        {
+            unsigned long long acquires;    //!< Calls to Acquire().
+            unsigned long long reuses;      //!< Acquires served from a free list.
+            unsigned long long releases;    //!< Calls to Release().
+            size_t bytesInUse;              //!< Size-class bytes handed out now.
+            size_t peakBytesInUse;          //!< Highest bytesInUse seen.
+            size_t bytesCached;             //!< Size-class bytes on the free lists.
+        };
+
+        //! The pool shared by all modules.
+        static BufferPool& Instance();
+
+        BufferPool();
+        BufferPool(const BufferPool&) = delete;
+        ~BufferPool();
+
+        /*!
+        * \brief Get an aligned buffer of at least \c length samples.
+        *
+        * The contents are undefined.
+        */
+        realval_t* Acquire(size_t length);
+
+        /*!
+        * \brief Give a buffer from Acquire() back to the pool. NULL is ignored.
+        */
+        void Release(realval_t *buf);
+
+        //! Number of samples \c buf can hold (its size class).
+        static size_t Capacity(const realval_t *buf);
+
+        //! Samples in the size class that \c length is rounded up to.
+        static size_t ClassSize(size_t length);
+
+        //! Return all cached buffers to the heap.
+        void Trim();
+
+        Stats GetStats() const;
+
+    private:
+        //! Stored just in front of each buffer.
+        struct Header
+        {
+            float *slab;        //!< What sseallocf() returned.
+            unsigned int cls;   //!< Size class, capacity is 1 << cls samples.
+        };
+
+        //! Smallest class, one cache line of samples.
+        static const unsigned int MinClass = 4;
+        static const unsigned int NumClasses = 48;
+
+        std::vector<realval_t*> m_free[NumClasses];
+        Stats m_stats;
+        mutable std::mutex m_lock;
+
+        static unsigned int sizeClass(size_t length);
+        static Header* header(const realval_t *buf);
+        static realval_t* allocSlab(unsigned int cls);
+        static void freeSlab(realval_t *buf);
+
+    }; /* BufferPool */
+
+}; /* namespace libsch */
+
+#endif /* BUFFERPOOL_H_ */
@@ -0,0 +1,105 @@
+#include "DecimatorModule.h"
+#include "BufferPool.h"
+#include "Common.h"
+#include "BlkDsp.h"
+
+
+namespace libsch{
+
+namespace
+{
+    //! Passband edge as a fraction of the output Nyquist frequency.
+    const double CutoffFraction = 0.8;
+
+    //! Floats per cache line, every band history starts on one.
+    const size_t LineAlign = BufferPool::Alignment/sizeof(float);
+}
+
+
+DecimatorModule::DecimatorModule(size_t datalength, size_t numBands, size_t ratio,
+                                 const std::string &id, BaseModule *parent,
+                                 size_t tapsPerPhase)
+    : BaseModule(id, parent)
+    , m_dataLength(datalength)
+    , m_numBands(numBands)
+    , m_ratio(ratio)
+    , m_taps(0)
+    , m_kernel(NULL)
+    , m_history(NULL)
+    , m_histStride(0)
+{
+    if (m_ratio < 1) m_ratio = 1;
+    if (m_ratio > datalength) m_ratio = datalength;
+    while (datalength % m_ratio != 0) --m_ratio;
+    if (m_ratio != ratio)
+    {
+        dbg_prt((std::string(__func__) + " Ratio " + std::to_string(ratio) +
+                    " does not divide the block length " + std::to_string(datalength) +
+                    ", using " + std::to_string(m_ratio) + " instead.").c_str());
+    }
+    if (tapsPerPhase < 1) tapsPerPhase = 1;
+
+    InDataLength(numBands*datalength);
+    OutDataLength(numBands*(datalength/m_ratio));
+
+    design(tapsPerPhase);
+}
+
+DecimatorModule::~DecimatorModule(void)
+{
+    BufferPool::Instance().Release(m_kernel);
+    BufferPool::Instance().Release(m_history);
+}
+
+//! Blackman windowed sinc, reversed so each output is a plain dot product.
+void DecimatorModule::design(size_t tapsPerPhase)
+{
+    m_taps = (m_ratio == 1) ? 1 : tapsPerPhase*m_ratio;
+    m_kernel = BufferPool::Instance().Acquire(m_taps);
+
+    float *win = new float[m_taps];
+    double fc = CutoffFraction*0.5/m_ratio;
+    icstdsp::BlkDsp::sinc(m_kernel, m_taps, fc*(m_taps-1));
+    icstdsp::BlkDsp::blackman(win, m_taps);
+    icstdsp::BlkDsp::mul(m_kernel, win, m_taps);
+    icstdsp::BlkDsp::mul(m_kernel, 1.0f/icstdsp::BlkDsp::sum(m_kernel, m_taps), m_taps);
+    icstdsp::BlkDsp::reverse(m_kernel, m_taps);
+    delete [] win;
+
+    m_histStride = (m_taps-1 + m_dataLength + LineAlign-1)/LineAlign*LineAlign;
+    m_history = BufferPool::Instance().Acquire(m_histStride*m_numBands);
+    Reset();
+}
+
+void DecimatorModule::Reset()
+{
+    memset(m_history, 0, m_histStride*m_numBands*sizeof(float));
+}
+
+/*
+ * y[j] = sum_k h[k]*x[j*ratio - k]. The block is appended to the history,
+ * every output is a dot product starting at j*ratio, then the newest
+ * taps-1 samples move to the front for the next block.
+ */
+void DecimatorModule::DoUpdate()
+{
+    const size_t dl = m_dataLength;
+    const size_t keep = m_taps-1;
+    const size_t outLen = dl/m_ratio;
+
+    for (size_t b = 0; b < m_numBands; ++b)
+    {
+        float *hist = m_history + b*m_histStride;
+        float *out = _outvec + b*outLen;
+
+        memcpy(hist + keep, _invec + b*dl, dl*sizeof(float));
+        for (size_t j = 0; j < outLen; ++j)
+        {
+            out[j] = icstdsp::BlkDsp::dotp(hist + j*m_ratio, m_kernel, static_cast<int>(m_taps));
+        }
+        memmove(hist, hist + dl, keep*sizeof(float));
+    }
+}
+
+
+} /*namespace libsch*/
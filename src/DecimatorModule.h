@@ -0,0 +1,103 @@
+#ifndef DECIMATORMODULE_H_
+#define DECIMATORMODULE_H_
+
+#include "Export.h"
+#include "BaseModule.h"
+
+#include <vector>
+
+namespace libsch
+{
+    /*!
+     * \class   DecimatorModule DecimatorModule.h
+     * \brief   Lowpass and downsample band-major signals by an integer ratio.
+     *
+     *          Meant to sit after an ExtractorModule: the envelopes are
+     *          band-limited to a few tens of Hz, so differentiation,
+     *          rectification and the resonators can run at 100-400 Hz instead
+     *          of the file rate.
+     *
+     *          The anti-alias filter is a linear phase windowed-sinc FIR of
+     *          \c tapsPerPhase*ratio taps (Blackman window, cutoff at 80% of
+     *          the output Nyquist, unit DC gain). It is evaluated in polyphase
+     *          form: only every ratio-th output is computed, as one SIMD dot
+     *          product (BlkDsp::dotp) of the reversed kernel with the input
+     *          history, so the cost is \c tapsPerPhase multiply-adds per input
+     *          sample regardless of the ratio. The last taps-1 input samples
+     *          of each band are kept, blocks join seamlessly.
+     *
+     *          Each output block holds exactly datalength/ratio samples per
+     *          band, so the ratio must divide \c datalength. If it does not,
+     *          the largest smaller ratio that does is used; see Ratio().
+     */
+    class DllExport DecimatorModule : public BaseModule
+    {
+
+    public:
+        /*!
+         * \param datalength    Input samples per band and block.
+         * \param numBands      Band-major signals in the input.
+         * \param ratio         Decimation ratio.
+         * \param id
+         * \param parent
+         * \param tapsPerPhase  FIR length in output samples, sets the
+         *                      steepness of the anti-alias filter.
+         */
+        DecimatorModule(size_t datalength, size_t numBands, size_t ratio,
+                        const std::string &id, BaseModule *parent=0,
+                        size_t tapsPerPhase=8);
+        ~DecimatorModule(void);
+
+        //! Decimation ratio actually used.
+        inline size_t Ratio() const;
+
+        //! Output samples per band and block.
+        inline size_t OutLength() const;
+
+        //! FIR length in input samples.
+        inline size_t Taps() const;
+
+        //! Clear the input history.
+        void Reset();
+
+    protected:
+        virtual void DoUpdate() override;
+
+    private:
+        size_t m_dataLength;
+        size_t m_numBands;
+        size_t m_ratio;
+        size_t m_taps;
+
+        //! Time reversed FIR kernel.
+        float *m_kernel;
+        //! Per band: taps-1 samples of history followed by one input block.
+        float *m_history;
+        size_t m_histStride;
+
+        void design(size_t tapsPerPhase);
+    };
+
+
+
+    /************************************************************************/
+    /*       INLINE DEFINITIONS                                             */
+    /************************************************************************/
+
+    inline size_t DecimatorModule::Ratio() const
+    {
+        return m_ratio;
+    }
+
+    inline size_t DecimatorModule::OutLength() const
+    {
+        return m_dataLength/m_ratio;
+    }
+
+    inline size_t DecimatorModule::Taps() const
+    {
+        return m_taps;
+    }
+
+}
+#endif /* DECIMATORMODULE_H_ */
@@ -1,15 +1,25 @@
 #include "ExtractorModule.h"
+#include "BufferPool.h"
 #include "Common.h"
 #include "BlkDsp.h"
 #include "AudioAnalysis.h"
 
+#include <algorithm>
+
 
 namespace libsch{
 
 ExtractorModule::ExtractorModule(uint winlength, size_t datalength, std::string &id,
-				BaseModule *parent)
+				BaseModule *parent, Method method, size_t numBands)
     : BaseModule(id, parent)
     , m_winLength(winlength)
+    , m_method(method)
+    , m_numBands(numBands < 1 ? 1 : numBands)
+    , m_dataLength(datalength)
+    , m_envState(m_numBands, 0.0f)
+    , m_attack(m_numBands, 200.0f)
+    , m_release(m_numBands, 2000.0f)
+    , m_lanes(NULL)
 {
     if (winlength > 8192)
     {
@@ -25,14 +35,18 @@ ExtractorModule::ExtractorModule(uint winlength, size_t datalength, std::string
 void ExtractorModule::init(int dl, int wl)
 {
 
-    //Initialize data arrays.
-    size_t datsz = icstdsp::BlkDsp::nexthipow2(dl+wl);
-    InDataLength(datsz);
-    OutDataLength(dl);
+    //Initialize data arrays. Exactly the band data is read.
+    size_t bandsz = m_numBands*dl;
+    InDataLength(bandsz);
+    OutDataLength(bandsz);
+
+    if (m_numBands > 1)
+    {
+        m_lanes = BufferPool::Instance().Acquire(bandsz);
+    }
 
     //Generate and save upper (right) half of Hann window.
-    m_window = new float[datsz];
-    memset(m_window, 0, datsz*sizeof(float));
+    m_window = new float[wl];
     
     //Calc a full period of Hann window.
     uint dblWinLen = wl << 1;
@@ -43,37 +57,89 @@ void ExtractorModule::init(int dl, int wl)
     float *start = &(twin[wl-1]);
     memcpy(m_window, start, wl*sizeof(float));
 
-
     delete [] twin;
+
+    //Smoothing kernel with unit DC gain, its spectrum is computed once.
+    if (m_method == ENV_HANN)
+    {
+        float sum = icstdsp::BlkDsp::sum(m_window, wl);
+        float *kernel = new float[wl];
+        memcpy(kernel, m_window, wl*sizeof(float));
+        icstdsp::BlkDsp::mul(kernel, 1.0f/sum, wl);
+        for (size_t b = 0; b < m_numBands; ++b)
+        {
+            m_smoothers.push_back(new OverlapSave(kernel, wl, dl));
+        }
+        delete [] kernel;
+    }
 }
 
 ExtractorModule::~ExtractorModule(void)
 {
     delete [] m_window;
+    for (size_t b = 0; b < m_smoothers.size(); ++b)
+    {
+        delete m_smoothers[b];
+    }
+    BufferPool::Instance().Release(m_lanes);
 }
 
+void ExtractorModule::Reset()
+{
+    std::fill(m_envState.begin(), m_envState.end(), 0.0f);
+    for (size_t b = 0; b < m_smoothers.size(); ++b)
+    {
+        m_smoothers[b]->Reset();
+    }
+}
 
 void ExtractorModule::DoUpdate()
 {
 //    dbg_prt((std::string("DoUpdate called on module: ") + id).c_str());
 
-    size_t inlength = InDataLength();
-    size_t outlength = OutDataLength();
+    const size_t dl = m_dataLength;
+    const size_t nb = m_numBands;
+
+    if (m_method == ENV_HANN)
+    {
+        //Rectify into the output, then smooth in place.
+        icstdsp::BlkDsp::copy(_outvec, _invec, nb*dl);
+        icstdsp::BlkDsp::abs(_outvec, nb*dl);
+        for (size_t b = 0; b < nb; ++b)
+        {
+            m_smoothers[b]->Process(_outvec + b*dl, _outvec + b*dl);
+        }
+        return;
+    }
 
-    //    float *twin = new float[inlength];
-    //    memcpy(twin, m_window, m_winLength*sizeof(float));
-    //
-    //
-    //    icstdsp::BlkDsp::abs(_invec,outlength);
-    //    icstdsp::BlkDsp::fconv(_invec, twin, outlength, m_winLength);
-    //    float *start = 	&(_invec[(m_winLength-1)>>1]);  //div by 2.
+    if (nb == 1)
+    {
+        icstdsp::AudioAnalysis::envelope(_invec, _outvec, m_envState[0], dl,
+                                         m_attack[0], m_release[0], 0);
+        return;
+    }
 
-    float c = 0.0f;
-    icstdsp::AudioAnalysis::envelope(_invec, _outvec, c, outlength, 200.0f, 2000.0f, 0);
+    //One follower per band in parallel lanes: interleave, follow, de-interleave.
+    for (size_t b = 0; b < nb; ++b)
+    {
+        const float *in = _invec + b*dl;
+        for (size_t i = 0; i < dl; ++i)
+        {
+            m_lanes[i*nb + b] = in[i];
+        }
+    }
+    icstdsp::AudioAnalysis::envelope(m_lanes, m_lanes, &m_envState[0], dl, nb,
+                                     &m_attack[0], &m_release[0], 0);
+    for (size_t b = 0; b < nb; ++b)
+    {
+        float *out = _outvec + b*dl;
+        for (size_t i = 0; i < dl; ++i)
+        {
+            out[i] = m_lanes[i*nb + b];
+        }
+    }
 
    // normTo1(_outvec, _outvec, outlength);
-
-//    delete [] twin;
 }
 
 
@@ -4,8 +4,10 @@
 
 #include "Export.h"
 #include "BaseModule.h"
+#include "OverlapSave.h"
 
 #include <math.h>
+#include <vector>
 
 namespace libsch
 {
@@ -13,38 +15,57 @@ namespace libsch
      * \class   ExtractorModule ExtractorModule.h
      * \brief   Extract the envelope of the input signal.
      * 
-     *          The actual size of the input vector for ExtractorModule is
-     *  		a little larger than the requested size. In fact, the number of bytes
-     *  		allocated for working data is given by:
-     *  		       allocated_bytes = sizeof(float)*nexthipow2(datalength+WIN_LENGTH)
-     *  		This extra data is required because of the fast convolution which
-     *  		is optimized for powers of two.
-     *  		However, the extra samples are not made available in the output of
-     *  	    this module.
-     *
-     *  	    The module uses the method described by Schierer.
+     *  	    The module uses the method described by Schierer: ENV_HANN
+     *  	    full-wave rectifies the input and smooths it with a half-Hann
+     *  	    window of \c winlength samples (normalized to unit DC gain),
+     *  	    using a streaming OverlapSave convolution whose window spectrum
+     *  	    is computed once. ENV_FOLLOWER uses an attack/release follower
+     *  	    instead.
      *  	    //TODO: provide reference to article.
+     *
+     *          Both methods carry their state from one Update() to the next,
+     *          so consecutive blocks give the same envelope as one long block
+     *          and the block size does not affect accuracy. Each block is
+     *          analysed exactly once; the input is exactly \c datalength
+     *          samples per band, so the parent's frame is read in place.
+     *
+     *          With \c numBands > 1 the input holds that many band-major
+     *          signals of \c datalength samples (e.g. the output of a
+     *          FilterbankModule) and the output holds their envelopes in the
+     *          same layout. ENV_FOLLOWER then runs one follower per band in
+     *          parallel SIMD lanes (AudioAnalysis::envelope, multi-channel).
      */
     class DllExport ExtractorModule : public BaseModule
     {
 
     public:
+        /*!
+        * \enum  Method
+        * \brief How the envelope is computed.
+        */
+        enum Method
+        {
+            ENV_FOLLOWER,   //!< Attack/release envelope follower.
+            ENV_HANN        //!< Rectify and smooth with a half-Hann window.
+        };
+
          /*!
-         * \brief Construct a new ExtractorModule. Allocates 
-         *        \c nexthipow2(winlength+datalength) sample buffers.
-         *
-         * In order to accommodate the convolution used
-         * in window extraction, the actual memory allocated for the input array is
-         * the next higher power of 2 of winlength+datalength.
+         * \brief Construct a new ExtractorModule.
          *
          * \param winlength
          * \param datalength
          * \param id
          * \param parent
+         * \param method    Envelope method.
+         * \param numBands  Band-major signals in the input.
          */
-        ExtractorModule(uint winlength, size_t datalength, std::string &id, BaseModule *parent=0);
+        ExtractorModule(uint winlength, size_t datalength, std::string &id, BaseModule *parent=0,
+                        Method method=ENV_FOLLOWER, size_t numBands=1);
         ~ExtractorModule(void);
 
+        //! Forget the envelope/smoothing state, e.g. before a new stream.
+        void Reset();
+
     protected:
         virtual void DoUpdate() override;
 
@@ -52,6 +73,20 @@ namespace libsch
         //! half-hanning window
         float *m_window;
         uint m_winLength;
+
+        Method m_method;
+        size_t m_numBands;
+        size_t m_dataLength;
+
+        //! Envelope follower continuation per band, carried across blocks.
+        std::vector<float> m_envState;
+        //! Follower attack/release time constants per band, in samples.
+        std::vector<float> m_attack;
+        std::vector<float> m_release;
+        //! Band interleaved scratch for the multi-lane follower.
+        float *m_lanes;
+        //! Half-Hann smoothing per band for ENV_HANN, empty otherwise.
+        std::vector<OverlapSave*> m_smoothers;
                 
         void init(int datalength, int winlength);
     };
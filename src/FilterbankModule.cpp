@@ -0,0 +1,241 @@
+#include "FilterbankModule.h"
+#include "BufferPool.h"
+
+#include "DspFilters/Butterworth.h"
+#include "DspFilters/ChebyshevI.h"
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+
+namespace libsch{
+
+namespace
+{
+    //! Scheirer's band edges in Hz, the top band runs to Nyquist.
+    const double BandEdgesHz[FilterbankModule::NumBands] = {
+        0.0, 200.0, 400.0, 800.0, 1600.0, 3200.0
+    };
+
+    const double ChebyshevRippleDb = 1.0;
+
+    //! Keeps the recursions out of the denormal range on silent input.
+    const float AntiDenormal = 1e-18f;
+
+    /*
+     * Copy the normalized biquads of \c f into lane \c lane of the stage
+     * major coefficient table. Missing stages become identity sections.
+     */
+    template<class FilterT>
+    void loadLane(FilterT &f, float *coef, int numStages, size_t lanes, size_t lane)
+    {
+        for (int s = 0; s < numStages; ++s) {
+            float *c = coef + s*5*lanes + lane;
+            if (s < f.getNumStages()) {
+                const Dsp::Cascade::Stage &st = f[s];
+                double a0 = st.getA0();
+                c[0*lanes] = static_cast<float>(st.getB0()/a0);
+                c[1*lanes] = static_cast<float>(st.getB1()/a0);
+                c[2*lanes] = static_cast<float>(st.getB2()/a0);
+                c[3*lanes] = static_cast<float>(st.getA1()/a0);
+                c[4*lanes] = static_cast<float>(st.getA2()/a0);
+            } else {
+                c[0*lanes] = 1.0f;
+                c[1*lanes] = c[2*lanes] = c[3*lanes] = c[4*lanes] = 0.0f;
+            }
+        }
+    }
+}
+
+
+FilterbankModule::FilterbankModule(size_t datalength, double sampleRate, const std::string &id,
+                                   BaseModule *parent, int order, Design design)
+    : BaseModule(datalength, NumBands*datalength, id, parent)
+    , m_dataLength(datalength)
+    , m_sampleRate(sampleRate)
+    , m_numStages(0)
+    , m_coef(NULL)
+    , m_state(NULL)
+    , m_work(NULL)
+{
+    if (order < 2 || order > 8 || (order & 1))
+    {
+        dbg_prt((std::string(__func__) + " Unsupported filter order: " +
+                    std::to_string(order) + ", using 4 instead.").c_str());
+        order = 4;
+    }
+
+    this->design(order, design);
+}
+
+FilterbankModule::~FilterbankModule(void)
+{
+    BufferPool::Instance().Release(m_coef);
+    BufferPool::Instance().Release(m_state);
+    BufferPool::Instance().Release(m_work);
+}
+
+//! Design the bands and lay their biquads out lane by lane.
+void FilterbankModule::design(int order, Design design)
+{
+    m_numStages = order/2;
+    m_coef = BufferPool::Instance().Acquire(m_numStages*5*Lanes);
+    m_state = BufferPool::Instance().Acquire(m_numStages*2*Lanes);
+    m_work = BufferPool::Instance().Acquire(m_dataLength*Lanes);
+
+    //Unused lanes pass their input through.
+    for (size_t lane = 0; lane < Lanes; ++lane)
+    {
+        for (int s = 0; s < m_numStages; ++s)
+        {
+            float *c = m_coef + s*5*Lanes + lane;
+            c[0] = 1.0f;
+            c[1*Lanes] = c[2*Lanes] = c[3*Lanes] = c[4*Lanes] = 0.0f;
+        }
+    }
+
+    const int bpOrder = order/2;
+    for (size_t b = 0; b < NumBands; ++b)
+    {
+        double lo = BandEdgesHz[b];
+        double hi = (b+1 < NumBands) ? BandEdgesHz[b+1] : 0.0;
+
+        if (design == FB_BUTTERWORTH)
+        {
+            if (b == 0) {
+                Dsp::Butterworth::LowPass<8> f;
+                f.setup(order, m_sampleRate, hi);
+                loadLane(f, m_coef, m_numStages, Lanes, b);
+            } else if (b+1 == NumBands) {
+                Dsp::Butterworth::HighPass<8> f;
+                f.setup(order, m_sampleRate, lo);
+                loadLane(f, m_coef, m_numStages, Lanes, b);
+            } else {
+                Dsp::Butterworth::BandPass<4> f;
+                f.setup(bpOrder, m_sampleRate, (lo+hi)/2, hi-lo);
+                loadLane(f, m_coef, m_numStages, Lanes, b);
+            }
+        }
+        else
+        {
+            if (b == 0) {
+                Dsp::ChebyshevI::LowPass<8> f;
+                f.setup(order, m_sampleRate, hi, ChebyshevRippleDb);
+                loadLane(f, m_coef, m_numStages, Lanes, b);
+            } else if (b+1 == NumBands) {
+                Dsp::ChebyshevI::HighPass<8> f;
+                f.setup(order, m_sampleRate, lo, ChebyshevRippleDb);
+                loadLane(f, m_coef, m_numStages, Lanes, b);
+            } else {
+                Dsp::ChebyshevI::BandPass<4> f;
+                f.setup(bpOrder, m_sampleRate, (lo+hi)/2, hi-lo, ChebyshevRippleDb);
+                loadLane(f, m_coef, m_numStages, Lanes, b);
+            }
+        }
+    }
+
+    Reset();
+}
+
+void FilterbankModule::Reset()
+{
+    memset(m_state, 0, m_numStages*2*Lanes*sizeof(float));
+}
+
+void FilterbankModule::BandEdges(double *edges) const
+{
+    for (size_t b = 0; b < NumBands; ++b)
+    {
+        edges[b] = BandEdgesHz[b];
+    }
+    edges[NumBands] = m_sampleRate/2;
+}
+
+/*
+ * One transposed direct form II step per stage, all bands at once:
+ *     y  = b0*x + s1
+ *     s1 = b1*x - a1*y + s2
+ *     s2 = b2*x - a2*y
+ * The lane interleaved results are transposed into band-major output at
+ * the end of the block.
+ */
+void FilterbankModule::DoUpdate()
+{
+    const size_t n = m_dataLength;
+    const int ns = m_numStages;
+    const float *in = _invec;
+    float *work = m_work;
+
+#if defined(__SSE__)
+    // Lanes 0-3 in the low register, 4-7 in the high one.
+    __m128 s1l[4], s1h[4], s2l[4], s2h[4];
+    for (int s = 0; s < ns; ++s)
+    {
+        s1l[s] = _mm_load_ps(m_state + (2*s+0)*Lanes);
+        s1h[s] = _mm_load_ps(m_state + (2*s+0)*Lanes + 4);
+        s2l[s] = _mm_load_ps(m_state + (2*s+1)*Lanes);
+        s2h[s] = _mm_load_ps(m_state + (2*s+1)*Lanes + 4);
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        __m128 xl = _mm_set1_ps(in[i] + AntiDenormal);
+        __m128 xh = xl;
+        for (int s = 0; s < ns; ++s)
+        {
+            const float *c = m_coef + s*5*Lanes;
+            __m128 yl = _mm_add_ps(_mm_mul_ps(_mm_load_ps(c), xl), s1l[s]);
+            __m128 yh = _mm_add_ps(_mm_mul_ps(_mm_load_ps(c + 4), xh), s1h[s]);
+            s1l[s] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_load_ps(c + Lanes), xl),
+                                           _mm_mul_ps(_mm_load_ps(c + 3*Lanes), yl)), s2l[s]);
+            s1h[s] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_load_ps(c + Lanes + 4), xh),
+                                           _mm_mul_ps(_mm_load_ps(c + 3*Lanes + 4), yh)), s2h[s]);
+            s2l[s] = _mm_sub_ps(_mm_mul_ps(_mm_load_ps(c + 2*Lanes), xl),
+                                _mm_mul_ps(_mm_load_ps(c + 4*Lanes), yl));
+            s2h[s] = _mm_sub_ps(_mm_mul_ps(_mm_load_ps(c + 2*Lanes + 4), xh),
+                                _mm_mul_ps(_mm_load_ps(c + 4*Lanes + 4), yh));
+            xl = yl;
+            xh = yh;
+        }
+        _mm_store_ps(work + i*Lanes, xl);
+        _mm_store_ps(work + i*Lanes + 4, xh);
+    }
+    for (int s = 0; s < ns; ++s)
+    {
+        _mm_store_ps(m_state + (2*s+0)*Lanes, s1l[s]);
+        _mm_store_ps(m_state + (2*s+0)*Lanes + 4, s1h[s]);
+        _mm_store_ps(m_state + (2*s+1)*Lanes, s2l[s]);
+        _mm_store_ps(m_state + (2*s+1)*Lanes + 4, s2h[s]);
+    }
+#else
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t l = 0; l < Lanes; ++l)
+        {
+            float x = in[i] + AntiDenormal;
+            for (int s = 0; s < ns; ++s)
+            {
+                const float *c = m_coef + s*5*Lanes + l;
+                float *st = m_state + 2*s*Lanes + l;
+                float y = c[0]*x + st[0];
+                st[0] = c[Lanes]*x - c[3*Lanes]*y + st[Lanes];
+                st[Lanes] = c[2*Lanes]*x - c[4*Lanes]*y;
+                x = y;
+            }
+            work[i*Lanes + l] = x;
+        }
+    }
+#endif
+
+    for (size_t b = 0; b < NumBands; ++b)
+    {
+        float *out = _outvec + b*n;
+        for (size_t i = 0; i < n; ++i)
+        {
+            out[i] = work[i*Lanes + b];
+        }
+    }
+}
+
+
+} /*namespace libsch*/
@@ -0,0 +1,110 @@
+#ifndef FILTERBANKMODULE_H_
+#define FILTERBANKMODULE_H_
+
+#include "Export.h"
+#include "BaseModule.h"
+
+namespace libsch
+{
+    /*!
+     * \class   FilterbankModule FilterbankModule.h
+     * \brief   Split the input into Scheirer's six frequency bands.
+     *
+     *          The bands are 0-200, 200-400, 400-800, 800-1600, 1600-3200 Hz
+     *          and 3200 Hz up: a lowpass, four bandpasses and a highpass,
+     *          designed with DspFilters (Butterworth or Chebyshev I). The
+     *          lowpass and highpass get \c order poles, the bandpasses
+     *          \c order/2 per band edge, so every band is a cascade of
+     *          order/2 biquads.
+     *
+     *          The bands are not filtered one after the other. All band
+     *          states sit side by side in 8 lanes (two 4 lane SSE
+     *          registers) and advance together, one transposed direct form
+     *          II step per biquad per sample.
+     *          The arithmetic is single precision.
+     *
+     *          The output is band-major: OutDataLength() is
+     *          NumBands*datalength and band \c b is at Band(b).
+     */
+    class DllExport FilterbankModule : public BaseModule
+    {
+
+    public:
+        //! Number of bands.
+        static const size_t NumBands = 6;
+
+        /*!
+        * \enum  Design
+        * \brief Filter family used for the bands.
+        */
+        enum Design
+        {
+            FB_BUTTERWORTH,     //!< Maximally flat pass band.
+            FB_CHEBYSHEV1       //!< 1 dB pass band ripple, steeper skirts.
+        };
+
+        /*!
+         * \brief Construct a FilterbankModule.
+         *
+         * \param datalength Input samples per block.
+         * \param sampleRate Sample rate of the input in Hz.
+         * \param id
+         * \param parent
+         * \param order      Band filter order, even, 2..8.
+         * \param design     Filter family.
+         */
+        FilterbankModule(size_t datalength, double sampleRate, const std::string &id,
+                         BaseModule *parent=0, int order=4, Design design=FB_BUTTERWORTH);
+        ~FilterbankModule(void);
+
+        //! Output of band \c b, DataLength() samples.
+        inline realval_t* Band(size_t b) const;
+
+        //! Input samples per block.
+        inline size_t DataLength() const;
+
+        //! Clear the filter states.
+        void Reset();
+
+        //! Band edges in Hz, NumBands+1 values, the last one is sampleRate/2.
+        void BandEdges(double *edges) const;
+
+    protected:
+        virtual void DoUpdate() override;
+
+    private:
+        //! SIMD lanes, one band per lane.
+        static const size_t Lanes = 8;
+
+        size_t m_dataLength;
+        double m_sampleRate;
+        int m_numStages;
+
+        //! Per stage: b0, b1, b2, a1, a2, each Lanes wide.
+        float *m_coef;
+        //! Per stage: s1, s2, each Lanes wide.
+        float *m_state;
+        //! Lane interleaved output, Lanes per sample.
+        float *m_work;
+
+        void design(int order, Design design);
+    };
+
+
+
+    /************************************************************************/
+    /*       INLINE DEFINITIONS                                             */
+    /************************************************************************/
+
+    inline realval_t* FilterbankModule::Band(size_t b) const
+    {
+        return _outvec + b*m_dataLength;
+    }
+
+    inline size_t FilterbankModule::DataLength() const
+    {
+        return m_dataLength;
+    }
+
+}
+#endif /* FILTERBANKMODULE_H_ */
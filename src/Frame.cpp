@@ -0,0 +1,125 @@
+/*
+ * Frame.cpp
+ *
+ *  Reference counted sample blocks shared between modules.
+ */
+
+#include "Frame.h"
+#include "BufferPool.h"
+
+#include <string.h>
+
+
+namespace libsch
+{
+
+
+Frame::Frame()
+    : m_block(NULL)
+{ }
+
+Frame::Frame(size_t length)
+    : m_block(allocBlock(length))
+{ }
+
+Frame::Frame(Block *block)
+    : m_block(block)
+{ }
+
+Frame::Frame(const Frame &other)
+    : m_block(other.m_block)
+{
+    if (NULL != m_block) {
+        m_block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Frame& Frame::operator=(const Frame &rhs)
+{
+    if (rhs.m_block != m_block) {
+        if (NULL != rhs.m_block) {
+            rhs.m_block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        release();
+        m_block = rhs.m_block;
+    }
+    return *this;
+}
+
+Frame::~Frame()
+{
+    release();
+}
+
+realval_t* Frame::MutableData()
+{
+    if (NULL == m_block) {
+        return NULL;
+    }
+
+    if (! Unique()) {
+        Block *copy = allocBlock(m_block->length);
+        memcpy(copy->data, m_block->data, m_block->length*sizeof(realval_t));
+        release();
+        m_block = copy;
+    }
+    return m_block->data;
+}
+
+Frame Frame::View(size_t length) const
+{
+    if (NULL == m_block || length > m_block->length) {
+        return Frame();
+    }
+
+    Block *base = (NULL == m_block->base) ? m_block : m_block->base;
+    base->refs.fetch_add(1, std::memory_order_relaxed);
+
+    Block *b = new Block;
+    b->refs.store(1, std::memory_order_relaxed);
+    b->length = length;
+    b->data = m_block->data;
+    b->base = base;
+    return Frame(b);
+}
+
+void Frame::Reset()
+{
+    release();
+}
+
+Frame::Block* Frame::allocBlock(size_t length)
+{
+    Block *b = new Block;
+    b->refs.store(1, std::memory_order_relaxed);
+    b->length = length;
+    b->data = BufferPool::Instance().Acquire(length);
+    b->base = NULL;
+    memset(b->data, 0, length*sizeof(realval_t));
+    return b;
+}
+
+void Frame::unref(Block *block)
+{
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (NULL == block->base) {
+            BufferPool::Instance().Release(block->data);
+        } else {
+            unref(block->base);
+        }
+        delete block;
+    }
+}
+
+//! Drop one reference, free the storage when it was the last one.
+void Frame::release()
+{
+    if (NULL == m_block) {
+        return;
+    }
+
+    unref(m_block);
+    m_block = NULL;
+}
+
+}; /* namespace libsch */
@@ -0,0 +1,151 @@
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include "BdTypes.h"
+#include "Export.h"
+
+#include <atomic>
+#include <stddef.h>
+
+namespace libsch
+{
+    /*!
+    \class  Frame Frame.h
+
+    \brief  A reference counted, read-only block of samples that a parent
+            module publishes once for all of its children.
+
+    Copying a Frame only copies a handle; every copy shares the same
+    storage. Readers go through Data(). A writer asks for MutableData(),
+    which first detaches (copies) the storage if somebody else still holds
+    a reference to it, so a published block never changes underneath a
+    reader.
+
+    Storage comes from BufferPool, so Data() is always aligned to
+    BufferPool::Alignment bytes.
+
+    The reference count is atomic, so handles may be passed between
+    threads. The samples themselves are not synchronized.
+    */
+    class DllExport Frame
+    {
+    public:
+        /*!
+        * \brief Make a null frame that has no storage.
+        */
+        Frame();
+
+        /*!
+        * \brief Make a frame with \c length zeroed samples.
+        */
+        explicit Frame(size_t length);
+
+        Frame(const Frame &other);
+        Frame& operator=(const Frame &rhs);
+        ~Frame();
+
+        /*!
+        * \brief Read-only pointer to the samples, NULL for a null frame.
+        */
+        inline const realval_t* Data() const;
+
+        /*!
+        * \brief Writable pointer to the samples.
+        *
+        * If the storage is shared with other handles it is copied first
+        * (copy-on-write), so the returned pointer is only visible through
+        * this handle.
+        */
+        realval_t* MutableData();
+
+        //! Number of samples in this frame.
+        inline size_t Length() const;
+
+        //! True if this frame has no storage.
+        inline bool IsNull() const;
+
+        //! True if this handle is the only reference to its storage.
+        inline bool Unique() const;
+
+        //! Drop this handle's reference and become a null frame.
+        void Reset();
+
+        /*!
+        * \brief Make a frame over the first \c length samples of this
+        *        frame's storage, with a reference count of its own.
+        *
+        * Writes through the view land in this frame's storage (and the
+        * other way round); copy-on-write only considers handles to the
+        * view itself. The view keeps the storage alive. Used to let
+        * modules with disjoint lifetimes share one buffer.
+        *
+        * \return A null frame if \c length exceeds Length().
+        */
+        Frame View(size_t length) const;
+
+        //! Exchange storage with \c other without touching reference counts.
+        inline void Swap(Frame &other);
+
+    private:
+        struct Block
+        {
+            std::atomic<int> refs;
+            size_t length;
+            realval_t *data;
+            Block *base;            //!< Owner of data for a View(), else NULL.
+        };
+
+        Block *m_block;
+
+        explicit Frame(Block *block);
+
+        static Block* allocBlock(size_t length);
+        static void unref(Block *block);
+        void release();
+
+    }; /* Frame */
+
+    //! ADL swap so containers exchange frames without touching the refcount.
+    inline void swap(Frame &a, Frame &b);
+
+
+
+    /************************************************************************/
+    /*       INLINE DEFINITIONS                                             */
+    /************************************************************************/
+
+    inline const realval_t* Frame::Data() const
+    {
+        return m_block == NULL ? NULL : m_block->data;
+    }
+
+    inline size_t Frame::Length() const
+    {
+        return m_block == NULL ? 0 : m_block->length;
+    }
+
+    inline bool Frame::IsNull() const
+    {
+        return m_block == NULL;
+    }
+
+    inline bool Frame::Unique() const
+    {
+        return m_block == NULL || m_block->refs.load(std::memory_order_acquire) == 1;
+    }
+
+    inline void Frame::Swap(Frame &other)
+    {
+        Block *tmp = m_block;
+        m_block = other.m_block;
+        other.m_block = tmp;
+    }
+
+    inline void swap(Frame &a, Frame &b)
+    {
+        a.Swap(b);
+    }
+
+}; /* namespace libsch */
+
+#endif /* FRAME_H_ */
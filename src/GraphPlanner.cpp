@@ -0,0 +1,167 @@
+/*
+ * GraphPlanner.cpp
+ *
+ *  Buffer lifetime analysis and slot sharing for BaseModule trees.
+ */
+
+#include "GraphPlanner.h"
+#include "prt_dbg.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+
+
+namespace libsch
+{
+
+
+GraphPlanner::GraphPlanner()
+    : m_report()
+{ }
+
+SCH_RESULT GraphPlanner::Plan(BaseModule *root)
+{
+    if (NULL == root) {
+        return SCH_ERR;
+    }
+
+    Release();
+    m_report = Report();
+    visit(root);
+
+    // Step of every module in serial update order.
+    std::map<const BaseModule*, size_t> step;
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        step[m_order[i]] = i;
+    }
+
+    const size_t forever = std::numeric_limits<size_t>::max();
+    std::vector<Buffer> bufs;
+    std::map<const BaseModule*, size_t> outBuf;
+    std::vector<BaseModule*> dropIn;
+
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        BaseModule *m = m_order[i];
+        size_t inBytes = m->InDataLength() * sizeof(realval_t);
+        m_report.bytesBefore += inBytes + m->OutDataLength() * sizeof(realval_t);
+
+        if (i == 0) {
+            m_report.bytesAfter += inBytes;     // the head's input belongs to the caller
+        } else if (m->NeedsInStore()) {
+            Buffer b = { m, false, m->InDataLength(), i, i, 0, false };
+            bufs.push_back(b);
+        } else {
+            dropIn.push_back(m);
+        }
+
+        const BaseModule::BaseModuleVector &kids = m->Children();
+        Buffer b = { m, true, m->OutDataLength(), i,
+                     kids.empty() ? forever : step[kids.back()], 0, false };
+
+        // The last child may overwrite its parent's output: nobody reads it later.
+        const BaseModule *p = m->Parent();
+        if (i > 0 && m->InPlace() && !m->NeedsInStore() && p->Children().back() == m) {
+            b.inPlace = true;
+        }
+
+        outBuf[m] = bufs.size();
+        bufs.push_back(b);
+    }
+
+    // Linear scan in order of first use: take the best fitting slot whose
+    // last use is over, grow the biggest free one if none fits, else open a
+    // new slot.
+    std::vector<size_t> slotSize, slotEnd;
+    for (size_t k = 0; k < bufs.size(); ++k) {
+        Buffer &b = bufs[k];
+
+        if (b.inPlace) {
+            b.slot = bufs[outBuf[b.module->Parent()]].slot;
+            m_report.inPlace++;
+        } else {
+            size_t best = slotSize.size();
+            for (size_t s = 0; s < slotSize.size(); ++s) {
+                if (slotEnd[s] >= b.start) {
+                    continue;
+                }
+                if (best == slotSize.size()) {
+                    best = s;
+                } else if (slotSize[best] < b.length) {
+                    if (slotSize[s] > slotSize[best]) best = s;
+                } else if (slotSize[s] >= b.length && slotSize[s] < slotSize[best]) {
+                    best = s;
+                }
+            }
+            if (best == slotSize.size()) {
+                slotSize.push_back(0);
+                slotEnd.push_back(0);
+            }
+            b.slot = best;
+        }
+
+        slotSize[b.slot] = std::max(slotSize[b.slot], b.length);
+        slotEnd[b.slot] = b.inPlace ? std::max(slotEnd[b.slot], b.end) : b.end;
+    }
+
+    std::vector<Frame> slots;
+    for (size_t s = 0; s < slotSize.size(); ++s) {
+        slots.push_back(Frame(slotSize[s]));
+        m_report.bytesAfter += slotSize[s] * sizeof(realval_t);
+    }
+
+    for (size_t k = 0; k < bufs.size(); ++k) {
+        Frame view = slots[bufs[k].slot].View(bufs[k].length);
+        if (bufs[k].output) {
+            bufs[k].module->SwapOutFrame(view);
+        } else {
+            bufs[k].module->SwapInStore(view);
+        }
+    }
+    for (size_t k = 0; k < dropIn.size(); ++k) {
+        Frame none;
+        dropIn[k]->SwapInStore(none);
+    }
+
+    m_report.modules = m_order.size();
+    m_report.buffers = bufs.size();
+    m_report.slots = slots.size();
+
+    dbg_prt(("GraphPlanner: " + std::to_string(m_report.bytesBefore) + " -> " +
+                std::to_string(m_report.bytesAfter) + " bytes in " +
+                std::to_string(m_report.slots) + " slots").c_str());
+
+    return SCH_OK;
+}
+
+void GraphPlanner::Release()
+{
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        BaseModule *m = m_order[i];
+        Frame out(m->OutDataLength());
+        m->SwapOutFrame(out);
+        if (i > 0) {
+            Frame in(m->InDataLength());
+            m->SwapInStore(in);
+        }
+    }
+    m_order.clear();
+}
+
+const GraphPlanner::Report& GraphPlanner::GetReport() const
+{
+    return m_report;
+}
+
+void GraphPlanner::visit(BaseModule *m)
+{
+    m_order.push_back(m);
+
+    const BaseModule::BaseModuleVector &kids = m->Children();
+    for (size_t i = 0; i < kids.size(); ++i) {
+        visit(kids[i]);
+    }
+}
+
+}; /* namespace libsch */
@@ -0,0 +1,99 @@
+#ifndef GRAPHPLANNER_H_
+#define GRAPHPLANNER_H_
+
+#include "BaseModule.h"
+#include "BdTypes.h"
+#include "Export.h"
+#include "Frame.h"
+
+#include <stddef.h>
+#include <vector>
+
+namespace libsch
+{
+    /*!
+    \class  GraphPlanner GraphPlanner.h
+
+    \brief  Compiles a BaseModule tree into a shared buffer plan.
+
+    Plan() walks the tree in the order the serial
+    BaseModule::Update(const Frame &) visits it and computes, for every
+    module buffer, the steps during which it holds live data:
+
+     - a module's output lives from its own step until its last child has
+       run; outputs of leaves live until the end of the pass,
+     - an input store (see BaseModule::NeedsInStore()) only lives during
+       its module's own step, unused stores are dropped.
+
+    Buffers whose lifetimes do not overlap are packed into the same shared
+    slot. A module that declares BaseModule::InPlace() and is the last
+    child of its parent writes straight into its parent's output.
+
+    The plan is only valid for serial updates from the root; do not run a
+    planned tree with ParallelExecutor or PipelineRunner. After an update
+    only the leaves' OutVec() hold meaningful data, and a module must not
+    keep state in _outvec between blocks. The head's input store is left
+    alone since the caller fills it.
+
+    Module data lengths must not change while planned. Release() gives
+    every module private buffers again. The shared slots are reference
+    counted through Frame::View(), so the planner may be destroyed before
+    or after the tree.
+    */
+    class DllExport GraphPlanner
+    {
+    public:
+        /*!
+        \struct Report
+        \brief  Working set before and after planning.
+        */
+        struct Report
+        {
+            size_t modules;         //!< Modules in the tree.
+            size_t buffers;         //!< Live buffers that needed a slot.
+            size_t slots;           //!< Shared slots backing them.
+            size_t inPlace;         //!< Modules writing over their parent's output.
+            size_t bytesBefore;     //!< Bytes of private buffers before planning.
+            size_t bytesAfter;      //!< Bytes of slots plus unplanned buffers.
+        };
+
+        GraphPlanner();
+        GraphPlanner(const GraphPlanner&) = delete;
+
+        /*!
+        * \brief Plan buffers for the tree under \c root and install the
+        *        shared storage in every module.
+        *
+        * A previous plan of the same planner is released first, so the
+        * tree it covered must still exist.
+        */
+        SCH_RESULT Plan(BaseModule *root);
+
+        //! Give every planned module private buffers again.
+        void Release();
+
+        //! Numbers from the last Plan().
+        const Report& GetReport() const;
+
+    private:
+        struct Buffer
+        {
+            BaseModule *module;
+            bool output;            //!< Output frame, else input store.
+            size_t length;
+            size_t start;           //!< First step the buffer is live.
+            size_t end;             //!< Last step the buffer is live.
+            size_t slot;
+            bool inPlace;           //!< Reuses the parent's output slot.
+        };
+
+        std::vector<BaseModule*> m_order;
+        Report                   m_report;
+
+        void visit(BaseModule *m);
+
+    }; /* GraphPlanner */
+
+}; /* namespace libsch */
+
+#endif /* GRAPHPLANNER_H_ */
@@ -1,27 +1,45 @@
-
-
+#ifndef MODULEBASE_H_
+#define MODULEBASE_H_
 
 #include "BdTypes.h"
 
+#include <stddef.h>
 #include <vector>
 
 
 namespace libsch
 {
 
+/*!
+\class  ModuleBase ModuleBase.h
+
+\brief  Interface for per-sample processors.
+
+tick() is virtual, so calling it once per sample costs an indirect call
+per sample. Hot paths should call process() once per block, or skip the
+virtual layer entirely and use a Chain (see FusedModule).
+*/
 template<class T>
-class ModuleBase 
+class ModuleBase
 {
 public:
 
     ModuleBase();
     ModuleBase(const ModuleBase &other);
-    ~ModuleBase();
+    virtual ~ModuleBase();
 
     ModuleBase& operator=(const ModuleBase &rhs);
-    
+
     virtual T tick(T val) = 0;
 
+    /*!
+    * \brief Run \c n samples of \c data through this processor in place.
+    *
+    * \return Number of output samples written to the front of \c data,
+    *         less than \c n for processors that decimate.
+    */
+    virtual size_t process(T *data, size_t n);
+
 private:
     std::vector<T> buf;
 
@@ -32,19 +50,250 @@ template<class T>
 ModuleBase<T>::ModuleBase() {}
 
 template<class T>
-ModuleBase<T>::ModuleBase(const ModuleBase<T> &other) {}
+ModuleBase<T>::ModuleBase(const ModuleBase<T> &other)
+    : buf(other.buf) {}
 
 template<class T>
 ModuleBase<T>::~ModuleBase() {}
 
 template<class T>
-ModuleBase<T>& operator=(const ModuleBase<T> &rhs) {}
+ModuleBase<T>& ModuleBase<T>::operator=(const ModuleBase<T> &rhs)
+{
+    buf = rhs.buf;
+    return *this;
+}
 
+template<class T>
+size_t ModuleBase<T>::process(T *data, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = tick(data[i]);
+    }
+    return n;
+}
 
 
 
-} //namespace libsch
+/************************************************************************/
+/*       FUSED SAMPLE PIPELINES                                         */
+/************************************************************************/
+
+/*
+ * A tick-style processor is any class with
+ *
+ *     template<class T> bool tick(T in, T &out);
+ *     void reset();
+ *
+ * tick() consumes one sample and returns true if it produced one in out.
+ * Processors are plain classes without virtual functions, so a Chain of
+ * them is a single inlinable function per sample.
+ */
+
+//! |x|
+struct Rectify
+{
+    template<class T>
+    inline bool tick(T in, T &out)
+    {
+        out = in < T(0) ? -in : in;
+        return true;
+    }
+
+    void reset() { }
+};
+
+//! One pole lowpass, y += coeff * (x - y).
+struct OnePole
+{
+    realval_t coeff;
+    realval_t state;
+
+    explicit OnePole(realval_t c = realval_t(0.01))
+        : coeff(c), state(0) { }
+
+    template<class T>
+    inline bool tick(T in, T &out)
+    {
+        state += coeff * (in - state);
+        out = state;
+        return true;
+    }
+
+    void reset() { state = 0; }
+};
+
+//! Keep every N'th sample. Put a lowpass (e.g. OnePole) in front of it.
+template<size_t N>
+struct Decimate
+{
+    size_t count;
+
+    Decimate()
+        : count(0) { }
+
+    template<class T>
+    inline bool tick(T in, T &out)
+    {
+        if (++count < N) {
+            return false;
+        }
+        count = 0;
+        out = in;
+        return true;
+    }
+
+    void reset() { count = 0; }
+};
+
+
+template<class... Ps> class Chain;
+template<size_t I, class C> struct ChainStage;
+
+/*!
+\class  Chain ModuleBase.h
+
+\brief  Compile-time composition of tick-style processors.
+
+Chain<Rectify, OnePole, Decimate<4> > runs every sample through all stages
+in order; a stage that produces no sample ends the chain for that input.
+Everything is resolved at compile time, so tick() inlines into one loop
+body and process() is the block version generated from it.
+
+Stages are default constructed, configure them through stage<I>().
+*/
+template<class P, class... Rest>
+class Chain<P, Rest...>
+{
+public:
+    template<class T>
+    inline bool tick(T in, T &out)
+    {
+        T mid;
+        return m_head.tick(in, mid) && m_tail.tick(mid, out);
+    }
+
+    /*!
+    * \brief Run \c n samples of \c buf through the chain in place.
+    * \return Number of outputs, packed at the front of \c buf.
+    */
+    template<class T>
+    size_t process(T *buf, size_t n)
+    {
+        return process(buf, buf, n);
+    }
+
+    /*!
+    * \brief Run \c n samples of \c in through the chain into \c out.
+    *
+    * \c out may be \c in. It needs room for \c n samples.
+    * \return Number of samples written to \c out.
+    */
+    template<class T>
+    size_t process(const T *in, T *out, size_t n)
+    {
+        size_t k = 0;
+        for (size_t i = 0; i < n; ++i) {
+            T y;
+            if (tick(in[i], y)) {
+                out[k++] = y;
+            }
+        }
+        return k;
+    }
+
+    //! Clear the state of every stage.
+    void reset()
+    {
+        m_head.reset();
+        m_tail.reset();
+    }
 
+    //! The I'th stage, counting from 0.
+    template<size_t I>
+    typename ChainStage<I, Chain>::type& stage()
+    {
+        return ChainStage<I, Chain>::get(*this);
+    }
 
+    P& head() { return m_head; }
+    Chain<Rest...>& tail() { return m_tail; }
 
+private:
+    P m_head;
+    Chain<Rest...> m_tail;
+};
+
+//! The empty chain passes samples through.
+template<>
+class Chain<>
+{
+public:
+    template<class T>
+    inline bool tick(T in, T &out)
+    {
+        out = in;
+        return true;
+    }
+
+    void reset() { }
+};
+
+template<class P, class... Rest>
+struct ChainStage<0, Chain<P, Rest...> >
+{
+    typedef P type;
+    static P& get(Chain<P, Rest...> &c) { return c.head(); }
+};
+
+template<size_t I, class P, class... Rest>
+struct ChainStage<I, Chain<P, Rest...> >
+{
+    typedef typename ChainStage<I - 1, Chain<Rest...> >::type type;
+    static type& get(Chain<P, Rest...> &c)
+    {
+        return ChainStage<I - 1, Chain<Rest...> >::get(c.tail());
+    }
+};
+
+
+/*!
+\class  FusedModule ModuleBase.h
+
+\brief  A ModuleBase made from a Chain, one virtual call per block.
+
+tick() returns the most recent output of the chain, which for decimating
+chains repeats between outputs.
+*/
+template<class T, class... Ps>
+class FusedModule : public ModuleBase<T>
+{
+public:
+    FusedModule()
+        : m_last(0) { }
+
+    T tick(T val)
+    {
+        m_chain.tick(val, m_last);
+        return m_last;
+    }
+
+    size_t process(T *buf, size_t n)
+    {
+        size_t k = m_chain.process(buf, n);
+        if (k > 0) {
+            m_last = buf[k - 1];
+        }
+        return k;
+    }
+
+    Chain<Ps...>& chain() { return m_chain; }
+
+private:
+    Chain<Ps...> m_chain;
+    T m_last;
+};
+
+
+} //namespace libsch
 
+#endif /* MODULEBASE_H_ */
@@ -0,0 +1,147 @@
+#include "OnsetModule.h"
+#include "BufferPool.h"
+#include "Common.h"
+#include "BlkDsp.h"
+#include "AudioAnalysis.h"
+
+#include <algorithm>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+
+namespace libsch{
+
+OnsetModule::OnsetModule(size_t datalength, const std::string &id, BaseModule *parent,
+                         size_t fftLength, size_t hop, Method method, float compression)
+    : BaseModule(id, parent)
+    , m_dataLength(datalength)
+    , m_method(method)
+    , m_compression(compression)
+    , m_stft(NULL)
+    , m_bins(0)
+    , m_log(NULL)
+    , m_prevLog(NULL)
+    , m_cont(NULL)
+{
+    size_t h = std::max<size_t>(1, std::min(hop, datalength));
+    while (datalength % h != 0) --h;
+    if (h != hop)
+    {
+        dbg_prt((std::string(__func__) + " Hop " + std::to_string(hop) +
+                    " does not divide the block length " + std::to_string(datalength) +
+                    ", using " + std::to_string(h) + " instead.").c_str());
+    }
+
+    m_stft = new Stft(std::max(fftLength, h), h, datalength/h,
+                      Stft::STFT_HANN, Stft::STFT_MAGNITUDE);
+    m_bins = m_stft->FrameLength();
+
+    InDataLength(datalength);
+    OutDataLength(datalength/m_stft->Hop());
+
+    m_log = BufferPool::Instance().Acquire(m_bins);
+    m_prevLog = BufferPool::Instance().Acquire(m_bins);
+    m_cont = BufferPool::Instance().Acquire(m_bins);
+
+    Reset();
+}
+
+OnsetModule::~OnsetModule(void)
+{
+    delete m_stft;
+    BufferPool::Instance().Release(m_log);
+    BufferPool::Instance().Release(m_prevLog);
+    BufferPool::Instance().Release(m_cont);
+}
+
+size_t OnsetModule::Hop() const
+{
+    return m_stft->Hop();
+}
+
+void OnsetModule::Reset()
+{
+    m_stft->Reset();
+
+    // Prime with fftLength-hop zeros so frames end on hop boundaries.
+    const float zero[64] = { 0 };
+    size_t fill = m_stft->FftLength() - m_stft->Hop();
+    while (fill > 0)
+    {
+        size_t n = std::min<size_t>(fill, 64);
+        m_stft->Push(zero, n);
+        fill -= n;
+    }
+
+    memset(m_prevLog, 0, m_bins*sizeof(float));
+    memset(m_cont, 0, m_bins*sizeof(float));
+}
+
+/*
+ * L = ln(1 + compression*|X|), then sum(max(0, L - Lprev)). The new log
+ * spectrum becomes the previous one by swapping buffers.
+ */
+float OnsetModule::logFlux(const float *mag)
+{
+    const int n = static_cast<int>(m_bins);
+    float *L = m_log;
+    const float *P = m_prevLog;
+
+    memcpy(L, mag, m_bins*sizeof(float));
+    icstdsp::BlkDsp::mul(L, m_compression, n);
+    icstdsp::BlkDsp::add(L, 1.0f, n);
+    icstdsp::BlkDsp::logabs(L, n);
+
+    int k = 0;
+    float flux = 0;
+#if defined(__SSE__)
+    __m128 a4 = _mm_setzero_ps();
+    const __m128 zero = _mm_setzero_ps();
+    for (; k+4 <= n; k += 4)
+    {
+        __m128 d = _mm_sub_ps(_mm_load_ps(L+k), _mm_load_ps(P+k));
+        a4 = _mm_add_ps(a4, _mm_max_ps(d, zero));
+    }
+    float part[4];
+    _mm_storeu_ps(part, a4);
+    flux = (part[0] + part[1]) + (part[2] + part[3]);
+#endif
+    for (; k < n; ++k)
+    {
+        float d = L[k] - P[k];
+        if (d > 0) flux += d;
+    }
+
+    std::swap(m_log, m_prevLog);
+    return flux;
+}
+
+void OnsetModule::DoUpdate()
+{
+    m_stft->Push(_invec, m_dataLength);
+
+    const size_t frames = m_stft->Available();
+    const int half = static_cast<int>(m_bins) - 1;
+    for (size_t j = 0; j < frames; ++j)
+    {
+        const float *mag = m_stft->Peek(j);
+        switch (m_method)
+        {
+        case ONSET_SPECTRALFLUX:
+            _outvec[j] = icstdsp::AudioAnalysis::spectralflux(const_cast<float*>(mag), m_cont, half);
+            break;
+        case ONSET_TRANSSPEC:
+            _outvec[j] = icstdsp::AudioAnalysis::transspec(const_cast<float*>(mag), m_cont, half);
+            break;
+        default:
+            _outvec[j] = logFlux(mag);
+            break;
+        }
+    }
+    m_stft->Pop(frames);
+}
+
+
+} /*namespace libsch*/
@@ -0,0 +1,89 @@
+#ifndef ONSETMODULE_H_
+#define ONSETMODULE_H_
+
+#include "Export.h"
+#include "BaseModule.h"
+#include "Stft.h"
+
+namespace libsch
+{
+    /*!
+     * \class   OnsetModule OnsetModule.h
+     * \brief   Onset strength of the input, one value per STFT hop.
+     *
+     *          The input runs through a streaming Stft (Hann window) and
+     *          every magnitude frame is reduced to one onset value:
+     *
+     *          - ONSET_LOGFLUX: log-compressed, half-wave rectified spectral
+     *            flux, sum_k max(0, L_n[k] - L_n-1[k]) with
+     *            L[k] = ln(1 + compression*|X[k]|). The log uses the SSE
+     *            polynomial of BlkDsp::logabs, the difference/rectify/sum
+     *            pass is a single SIMD loop.
+     *          - ONSET_SPECTRALFLUX: AudioAnalysis::spectralflux.
+     *          - ONSET_TRANSSPEC: AudioAnalysis::transspec.
+     *
+     *          The STFT is primed with fftLength-hop zeros, so every block of
+     *          \c datalength samples yields exactly datalength/hop values and
+     *          value j ends at input sample (j+1)*hop. The previous spectrum
+     *          and the STFT input carry over from block to block.
+     *
+     *          \c hop must divide \c datalength; if it does not, the largest
+     *          smaller hop that does is used.
+     */
+    class DllExport OnsetModule : public BaseModule
+    {
+
+    public:
+        /*!
+        * \enum  Method
+        * \brief Frame to onset value reduction.
+        */
+        enum Method
+        {
+            ONSET_LOGFLUX,      //!< Log-compressed rectified flux.
+            ONSET_SPECTRALFLUX, //!< AudioAnalysis::spectralflux.
+            ONSET_TRANSSPEC     //!< AudioAnalysis::transspec.
+        };
+
+        /*!
+         * \param datalength    Input samples per block.
+         * \param id
+         * \param parent
+         * \param fftLength     STFT frame length, power of 2.
+         * \param hop           Samples between onset values.
+         * \param method
+         * \param compression   Log compression factor for ONSET_LOGFLUX.
+         */
+        OnsetModule(size_t datalength, const std::string &id, BaseModule *parent=0,
+                    size_t fftLength=1024, size_t hop=512,
+                    Method method=ONSET_LOGFLUX, float compression=100.0f);
+        ~OnsetModule(void);
+
+        //! Input samples per onset value.
+        size_t Hop() const;
+
+        //! Forget the STFT input and the previous spectrum.
+        void Reset();
+
+    protected:
+        virtual void DoUpdate() override;
+
+    private:
+        size_t m_dataLength;
+        Method m_method;
+        float m_compression;
+
+        Stft *m_stft;
+        //! Bins per magnitude frame, fftLength/2+1.
+        size_t m_bins;
+        //! Current and previous log spectrum for ONSET_LOGFLUX.
+        float *m_log;
+        float *m_prevLog;
+        //! Continuation data of the AudioAnalysis detectors.
+        float *m_cont;
+
+        float logFlux(const float *mag);
+    };
+
+}
+#endif /* ONSETMODULE_H_ */
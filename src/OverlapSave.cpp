@@ -0,0 +1,92 @@
+/*
+ * OverlapSave.cpp
+ *
+ *  Streaming overlap-save FFT convolution.
+ */
+
+#include "OverlapSave.h"
+
+#include "Common.h"
+#include "BlkDsp.h"
+
+#include <string.h>
+
+
+namespace libsch
+{
+
+using icstdsp::BlkDsp;
+
+
+OverlapSave::OverlapSave(const float *kernel, size_t kernelLength, size_t blockLength)
+    : m_blockLength(blockLength)
+    , m_kernelLength(kernelLength)
+    , m_fftLength(BlkDsp::nexthipow2(static_cast<int>(blockLength + kernelLength - 1)))
+{
+    int n = static_cast<int>(m_fftLength);
+    m_kernelSpec = BlkDsp::sseallocf(n);
+    m_history = BlkDsp::sseallocf(n);
+    m_work = BlkDsp::sseallocf(n);
+
+    BlkDsp::set(m_kernelSpec, 0, n);
+    memcpy(m_kernelSpec, kernel, kernelLength*sizeof(float));
+    BlkDsp::realfft(m_kernelSpec, n);
+
+    Reset();
+}
+
+OverlapSave::~OverlapSave()
+{
+    BlkDsp::ssefree(m_kernelSpec);
+    BlkDsp::ssefree(m_history);
+    BlkDsp::ssefree(m_work);
+}
+
+/*
+ * Frame = [saved input | new block]. After the circular convolution of the
+ * frame with the kernel, the last blockLength samples are free of
+ * wrap-around because the saved part is at least kernelLength-1 long.
+ */
+void OverlapSave::Process(const float *in, float *out)
+{
+    int n = static_cast<int>(m_fftLength);
+    int b = static_cast<int>(m_blockLength);
+    int keep = n - b;
+
+    memcpy(m_history + keep, in, m_blockLength*sizeof(float));
+    BlkDsp::copy(m_work, m_history, n);
+    BlkDsp::copy(m_history, m_history + b, keep);
+
+    // Multiply packed spectra as BlkDsp::fconv does: [1] holds the real
+    // Nyquist bin, keep it out of the complex product.
+    BlkDsp::realfft(m_work, n);
+    float nyq = m_work[1]*m_kernelSpec[1];
+    m_work[1] = 0;
+    BlkDsp::cpxmul(m_work, m_kernelSpec, n >> 1);
+    m_work[1] = nyq;
+    BlkDsp::realifft(m_work, n);
+
+    memcpy(out, m_work + keep, m_blockLength*sizeof(float));
+}
+
+void OverlapSave::Reset()
+{
+    BlkDsp::set(m_history, 0, static_cast<int>(m_fftLength));
+}
+
+size_t OverlapSave::BlockLength() const
+{
+    return m_blockLength;
+}
+
+size_t OverlapSave::KernelLength() const
+{
+    return m_kernelLength;
+}
+
+size_t OverlapSave::FftLength() const
+{
+    return m_fftLength;
+}
+
+}; /* namespace libsch */
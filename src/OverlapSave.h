@@ -0,0 +1,68 @@
+#ifndef OVERLAPSAVE_H_
+#define OVERLAPSAVE_H_
+
+#include "Export.h"
+
+#include <stddef.h>
+
+namespace libsch
+{
+    /*!
+    \class  OverlapSave OverlapSave.h
+
+    \brief  Streaming FFT convolution of consecutive blocks with a fixed
+            kernel, by the overlap-save method.
+
+    The kernel spectrum is computed once in the constructor. Every call to
+    Process() takes the next \c blockLength input samples and returns the
+    matching \c blockLength samples of the causal convolution, exactly as
+    if the whole stream had been convolved at once. The last
+    FftLength()-BlockLength() input samples are kept between calls.
+
+    FftLength() is nexthipow2(blockLength + kernelLength - 1).
+    */
+    class DllExport OverlapSave
+    {
+    public:
+        /*!
+        * \param kernel       Impulse response, copied.
+        * \param kernelLength Samples in \c kernel.
+        * \param blockLength  Samples per Process() call.
+        */
+        OverlapSave(const float *kernel, size_t kernelLength, size_t blockLength);
+        OverlapSave(const OverlapSave&) = delete;
+        OverlapSave& operator=(const OverlapSave&) = delete;
+        ~OverlapSave();
+
+        /*!
+        * \brief Convolve the next block.
+        *
+        * \param in  BlockLength() new input samples.
+        * \param out BlockLength() output samples, may be \c in.
+        */
+        void Process(const float *in, float *out);
+
+        //! Clear the saved input, as if the stream started over.
+        void Reset();
+
+        size_t BlockLength() const;
+        size_t KernelLength() const;
+        size_t FftLength() const;
+
+    private:
+        size_t m_blockLength;
+        size_t m_kernelLength;
+        size_t m_fftLength;
+
+        //! Packed realfft spectrum of the zero padded kernel.
+        float *m_kernelSpec;
+        //! Last FftLength()-BlockLength() input samples followed by the new block.
+        float *m_history;
+        //! FFT work buffer.
+        float *m_work;
+
+    }; /* OverlapSave */
+
+}; /* namespace libsch */
+
+#endif /* OVERLAPSAVE_H_ */
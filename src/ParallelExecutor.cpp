@@ -0,0 +1,62 @@
+/*
+ * ParallelExecutor.cpp
+ *
+ *  Runs independent branches of a BaseModule tree on a thread pool.
+ */
+
+#include "ParallelExecutor.h"
+
+
+namespace libsch
+{
+
+
+ParallelExecutor::ParallelExecutor(unsigned int maxThreads)
+    : m_pool(maxThreads)
+{ }
+
+void ParallelExecutor::Run(BaseModule *root, const Frame &in)
+{
+    if (NULL == root) {
+        return;
+    }
+
+    schedule(root, in);
+    m_pool.Wait();
+}
+
+unsigned int ParallelExecutor::NumThreads() const
+{
+    return m_pool.NumThreads();
+}
+
+void ParallelExecutor::schedule(BaseModule *module, const Frame &in)
+{
+    m_pool.Submit([this, module, in]() { update(module, in); });
+}
+
+/*
+ * Process one module, then make its children ready. All but the first
+ * child go to the pool; the first one continues on this thread so a
+ * straight chain never touches a queue.
+ */
+void ParallelExecutor::update(BaseModule *module, Frame in)
+{
+    for (;;) {
+        module->Process(in);
+
+        const BaseModule::BaseModuleVector &kids = module->Children();
+        if (kids.empty()) {
+            return;
+        }
+
+        for (size_t i = 1; i < kids.size(); ++i) {
+            schedule(kids[i], module->OutFrame());
+        }
+
+        in = module->OutFrame();
+        module = kids[0];
+    }
+}
+
+}; /* namespace libsch */
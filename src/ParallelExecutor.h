@@ -0,0 +1,59 @@
+#ifndef PARALLELEXECUTOR_H_
+#define PARALLELEXECUTOR_H_
+
+#include "BaseModule.h"
+#include "Export.h"
+#include "Frame.h"
+#include "ThreadPool.h"
+
+namespace libsch
+{
+    /*!
+    \class  ParallelExecutor ParallelExecutor.h
+
+    \brief  Opt-in executor that updates a BaseModule tree with sibling
+            branches running concurrently.
+
+    A module becomes ready as soon as its parent has finished; all ready
+    modules are handed to a work-stealing ThreadPool. Each child reads its
+    parent's OutFrame() in place, exactly as in the serial
+    BaseModule::Update(const Frame &), so the output of every module is
+    bit-identical to serial execution as long as DoUpdate() only touches
+    the module's own state.
+
+    Run() returns when every module in the tree has been updated.
+    */
+    class DllExport ParallelExecutor
+    {
+    public:
+        /*!
+        * \param maxThreads Cap on the number of worker threads, 0 uses
+        *        one per hardware thread.
+        */
+        explicit ParallelExecutor(unsigned int maxThreads = 0);
+        ParallelExecutor(const ParallelExecutor&) = delete;
+
+        /*!
+        * \brief Update \c root and all of its descendants, blocking until
+        *        they are done.
+        *
+        * \param root The pipeline head.
+        * \param in   Input for \c root, a null frame leaves root's _invec
+        *             untouched (see BaseModule::Update(const Frame &)).
+        */
+        void Run(BaseModule *root, const Frame &in = Frame());
+
+        //! Number of worker threads.
+        unsigned int NumThreads() const;
+
+    private:
+        ThreadPool m_pool;
+
+        void schedule(BaseModule *module, const Frame &in);
+        void update(BaseModule *module, Frame in);
+
+    }; /* ParallelExecutor */
+
+}; /* namespace libsch */
+
+#endif /* PARALLELEXECUTOR_H_ */
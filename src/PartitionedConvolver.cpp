@@ -0,0 +1,206 @@
+/*
+ * PartitionedConvolver.cpp
+ *
+ *  Streaming partitioned overlap-save FFT convolution.
+ */
+
+#include "PartitionedConvolver.h"
+
+#include "Common.h"
+#include "BlkDsp.h"
+
+#include <algorithm>
+#include <string.h>
+
+
+namespace libsch
+{
+
+using icstdsp::BlkDsp;
+
+
+PartitionedConvolver::PartitionedConvolver(const float *kernel, size_t kernelLength,
+                                           size_t partitionLength, size_t maxPartitionLength)
+    : m_kernelLength(kernelLength)
+    , m_partitionLength(BlkDsp::nexthipow2(
+          static_cast<int>(std::max<size_t>(partitionLength, 4))))
+{
+    size_t b = m_partitionLength;
+    size_t length = b;
+    size_t offset = 0;
+
+    // Level sizes b, 4b, 16b, ..., 3 partitions each but the last. The
+    // level of size N covers the kernel from N-b to 4N-b.
+    while (offset < kernelLength)
+    {
+        bool last = 4*length > maxPartitionLength;
+        size_t segment = kernelLength - offset;
+        size_t partitions = (segment + length - 1)/length;
+        if (!last)
+        {
+            partitions = std::min<size_t>(partitions, 3);
+            segment = std::min(segment, partitions*length);
+        }
+
+        Level level;
+        int m = static_cast<int>(2*length);
+        level.length = length;
+        level.partitions = partitions;
+        level.spec = BlkDsp::sseallocf(m*static_cast<int>(partitions));
+        level.specNyq = BlkDsp::sseallocf(static_cast<int>(partitions));
+        level.fdl = BlkDsp::sseallocf(m*static_cast<int>(partitions));
+        level.fdlNyq = BlkDsp::sseallocf(static_cast<int>(partitions));
+        level.input = BlkDsp::sseallocf(m);
+        level.output = BlkDsp::sseallocf(static_cast<int>(length));
+        level.work = BlkDsp::sseallocf(m);
+
+        for (size_t p = 0; p < partitions; ++p)
+        {
+            float *h = level.spec + p*m;
+            size_t count = std::min(length, segment - p*length);
+            BlkDsp::set(h, 0, m);
+            memcpy(h, kernel + offset + p*length, count*sizeof(float));
+            BlkDsp::realfft(h, m);
+            level.specNyq[p] = h[1];
+            h[1] = 0;
+        }
+
+        m_levels.push_back(level);
+        if (last)
+            break;
+        offset = 4*length - b;
+        length *= 4;
+    }
+
+    m_scratch = BlkDsp::sseallocf(static_cast<int>(b));
+
+    Reset();
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    for (Level &level : m_levels)
+    {
+        BlkDsp::ssefree(level.spec);
+        BlkDsp::ssefree(level.specNyq);
+        BlkDsp::ssefree(level.fdl);
+        BlkDsp::ssefree(level.fdlNyq);
+        BlkDsp::ssefree(level.input);
+        BlkDsp::ssefree(level.output);
+        BlkDsp::ssefree(level.work);
+    }
+    BlkDsp::ssefree(m_scratch);
+}
+
+/*
+ * All levels advance in step. A chunk never crosses a multiple of the
+ * partition length, and the larger lengths are multiples of it, so a chunk
+ * completes at most one block per level. The chunk's output is taken
+ * before its input is stored, since out may be in.
+ */
+void PartitionedConvolver::Process(const float *in, float *out, size_t n)
+{
+    while (n > 0)
+    {
+        size_t take = std::min(n, m_partitionLength - m_levels[0].fill);
+        int count = static_cast<int>(take);
+
+        BlkDsp::copy(m_scratch, m_levels[0].output + m_levels[0].fill, count);
+        for (size_t l = 1; l < m_levels.size(); ++l)
+            BlkDsp::add(m_scratch, m_levels[l].output + m_levels[l].fill, count);
+
+        for (Level &level : m_levels)
+        {
+            memcpy(level.input + level.length + level.fill, in, take*sizeof(float));
+            level.fill += take;
+            if (level.fill == level.length)
+            {
+                Transform(level);
+                level.fill = 0;
+            }
+        }
+
+        memcpy(out, m_scratch, take*sizeof(float));
+        in += take;
+        out += take;
+        n -= take;
+    }
+}
+
+/*
+ * Frame = [previous N | new N] -> newest delay line slot. Slot newest-p
+ * meets partition p; the last N samples of the inverse transform are the
+ * output block. [1] holds the real Nyquist bin of the packed spectra, it
+ * is zero in the stored spectra and accumulated apart.
+ */
+void PartitionedConvolver::Transform(Level &level)
+{
+    size_t n = level.length;
+    size_t m = 2*n;
+    size_t slot = level.newest = (level.newest + 1) % level.partitions;
+
+    float *x = level.fdl + slot*m;
+    BlkDsp::copy(x, level.input, static_cast<int>(m));
+    BlkDsp::copy(level.input, level.input + n, static_cast<int>(n));
+    BlkDsp::realfft(x, static_cast<int>(m));
+    level.fdlNyq[slot] = x[1];
+    x[1] = 0;
+
+    float nyq = 0;
+    BlkDsp::set(level.work, 0, static_cast<int>(m));
+    for (size_t p = 0; p < level.partitions; ++p)
+    {
+        BlkDsp::cpxmac(level.work, level.fdl + slot*m, level.spec + p*m,
+                       static_cast<int>(n));
+        nyq += level.fdlNyq[slot]*level.specNyq[p];
+        slot = (slot == 0) ? level.partitions - 1 : slot - 1;
+    }
+    level.work[1] = nyq;
+    BlkDsp::realifft(level.work, static_cast<int>(m));
+
+    memcpy(level.output, level.work + n, n*sizeof(float));
+}
+
+void PartitionedConvolver::Reset()
+{
+    for (Level &level : m_levels)
+    {
+        int m = static_cast<int>(2*level.length);
+        level.fill = 0;
+        level.newest = 0;
+        BlkDsp::set(level.fdl, 0, m*static_cast<int>(level.partitions));
+        BlkDsp::set(level.fdlNyq, 0, static_cast<int>(level.partitions));
+        BlkDsp::set(level.input, 0, m);
+        BlkDsp::set(level.output, 0, static_cast<int>(level.length));
+    }
+}
+
+size_t PartitionedConvolver::KernelLength() const
+{
+    return m_kernelLength;
+}
+
+size_t PartitionedConvolver::PartitionLength() const
+{
+    return m_partitionLength;
+}
+
+size_t PartitionedConvolver::Latency() const
+{
+    return m_partitionLength;
+}
+
+size_t PartitionedConvolver::Partitions() const
+{
+    size_t partitions = 0;
+    for (const Level &level : m_levels)
+        partitions += level.partitions;
+    return partitions;
+}
+
+size_t PartitionedConvolver::Levels() const
+{
+    return m_levels.size();
+}
+
+}; /* namespace libsch */
@@ -0,0 +1,118 @@
+#ifndef PARTITIONEDCONVOLVER_H_
+#define PARTITIONEDCONVOLVER_H_
+
+#include "Export.h"
+
+#include <stddef.h>
+#include <vector>
+
+namespace libsch
+{
+    /*!
+    \class  PartitionedConvolver PartitionedConvolver.h
+
+    \brief  Streaming FFT convolution with a long kernel, by uniformly
+            (optionally non-uniformly) partitioned overlap-save.
+
+    The kernel is cut into partitions of PartitionLength() samples. Their
+    spectra (FFT size 2*PartitionLength()) are computed once in the
+    constructor. Every PartitionLength() input samples one forward FFT is
+    taken and stored in a frequency-domain delay line; the output block is
+    the sum of the delay line spectra times the partition spectra, followed
+    by one inverse FFT. The cost per sample therefore grows with the number
+    of partitions only through one complex multiply-add per bin, instead of
+    with the kernel length as for OverlapSave.
+
+    Process() accepts any number of samples per call. The output is the
+    causal convolution delayed by Latency() = PartitionLength() samples.
+
+    With \c maxPartitionLength above \c partitionLength the partition size
+    grows by a factor of 4 per level: 3 partitions of each size, the last
+    level takes the rest. A level of size N starts at kernel offset
+    N - PartitionLength(), so its own latency of N lines up with the total
+    latency. Large levels cut the number of multiply-adds for long kernels,
+    but their transforms run in the call that completes their block, so the
+    cost per call is less even. Nothing is allocated after construction.
+    */
+    class DllExport PartitionedConvolver
+    {
+    public:
+        /*!
+        * \param kernel             Impulse response, copied.
+        * \param kernelLength       Samples in \c kernel, > 0.
+        * \param partitionLength    Samples per partition and latency,
+        *                           rounded up to a power of 2, at least 4.
+        * \param maxPartitionLength Largest partition, 0 or <= partitionLength
+        *                           for uniform partitions.
+        */
+        PartitionedConvolver(const float *kernel, size_t kernelLength,
+                             size_t partitionLength, size_t maxPartitionLength=0);
+        PartitionedConvolver(const PartitionedConvolver&) = delete;
+        PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+        ~PartitionedConvolver();
+
+        /*!
+        * \brief Convolve the next \c n samples.
+        *
+        * \param in  \c n new input samples.
+        * \param out \c n output samples, delayed by Latency(), may be \c in.
+        * \param n   Any number of samples.
+        */
+        void Process(const float *in, float *out, size_t n);
+
+        //! Clear the delay lines, as if the stream started over.
+        void Reset();
+
+        size_t KernelLength() const;
+        size_t PartitionLength() const;
+
+        //! Samples between an input and its first output, PartitionLength().
+        size_t Latency() const;
+
+        //! Partitions of all levels.
+        size_t Partitions() const;
+
+        //! Number of partition sizes in use, 1 for uniform partitions.
+        size_t Levels() const;
+
+    private:
+        //! Uniformly partitioned convolution with one kernel segment.
+        struct Level
+        {
+            //! Partition length N, the FFT size is 2N.
+            size_t length;
+            size_t partitions;
+            //! Input samples collected for the next transform, 0..N-1.
+            size_t fill;
+            //! Delay line slot of the newest input spectrum.
+            size_t newest;
+
+            //! Packed partition spectra with [1] = 0, Nyquist bins apart.
+            float *spec;
+            float *specNyq;
+            //! Delay line of input spectra, same format.
+            float *fdl;
+            float *fdlNyq;
+            //! Previous N input samples followed by the N being collected.
+            float *input;
+            //! N output samples being emitted.
+            float *output;
+            //! Spectrum accumulator and FFT work buffer, 2N.
+            float *work;
+        };
+
+        void Transform(Level &level);
+
+        size_t m_kernelLength;
+        size_t m_partitionLength;
+
+        std::vector<Level> m_levels;
+
+        //! Output of the current chunk, summed over the levels.
+        float *m_scratch;
+
+    }; /* PartitionedConvolver */
+
+}; /* namespace libsch */
+
+#endif /* PARTITIONEDCONVOLVER_H_ */
@@ -0,0 +1,231 @@
+/*
+ * PipelineRunner.cpp
+ *
+ *  Stage-per-thread execution of a module chain over SPSC frame rings.
+ */
+
+#include "PipelineRunner.h"
+#include "prt_dbg.h"
+
+#include <algorithm>
+#include <string.h>
+
+
+namespace libsch
+{
+
+
+PipelineRunner::PipelineRunner(size_t ringSize)
+    : m_ringSize(ringSize < 1 ? 1 : ringSize)
+    , m_inputClosed(false)
+    , m_running(false)
+{ }
+
+PipelineRunner::~PipelineRunner()
+{
+    Stop();
+    clearRings();
+    for (size_t k = 0; k < m_stages.size(); ++k) {
+        delete m_stages[k];
+    }
+}
+
+SCH_RESULT PipelineRunner::AddStage(BaseModule *module)
+{
+    if (m_running || NULL == module) {
+        return SCH_ERR;
+    }
+    if (!m_stages.empty() && module->Parent() != m_stages.back()->module) {
+        dbg_prt((std::string(__func__) + ": " + module->Id() +
+                    " is not a child of the previous stage").c_str());
+        return SCH_ERR_ADD_CHILD;
+    }
+
+    Stage *s = new Stage();
+    s->module = module;
+    s->full = NULL;
+    s->free = NULL;
+    s->done = false;
+    s->blocks = 0;
+    s->depthSum = 0;
+    s->maxDepth = 0;
+    m_stages.push_back(s);
+
+    return SCH_OK;
+}
+
+SCH_RESULT PipelineRunner::Start()
+{
+    if (m_running || m_stages.empty()) {
+        return SCH_ERR;
+    }
+
+    clearRings();
+    for (size_t k = 0; k < m_stages.size(); ++k) {
+        Stage *s = m_stages[k];
+        size_t len = (k == 0)
+            ? s->module->InDataLength()
+            : m_stages[k - 1]->module->OutDataLength();
+
+        s->full = new FrameRing(m_ringSize);
+        s->free = new FrameRing(m_ringSize);
+        for (size_t i = 0; i < m_ringSize; ++i) {
+            Frame f(len);
+            s->free->TryPush(f);
+        }
+
+        s->done = false;
+        s->blocks = 0;
+        s->depthSum = 0;
+        s->maxDepth = 0;
+    }
+
+    m_inputClosed = false;
+    m_running = true;
+    for (size_t k = 0; k < m_stages.size(); ++k) {
+        m_threads.push_back(std::thread(&PipelineRunner::stageLoop, this, k));
+    }
+
+    return SCH_OK;
+}
+
+SCH_RESULT PipelineRunner::Push(const realval_t *data, size_t n)
+{
+    if (!m_running || NULL == data) {
+        return SCH_ERR;
+    }
+
+    Stage *s = m_stages[0];
+    Frame f;
+    s->free->Pop(f);
+
+    realval_t *d = f.MutableData();
+    size_t len = std::min(n, f.Length());
+    memcpy(d, data, len * sizeof(realval_t));
+    memset(d + len, 0, (f.Length() - len) * sizeof(realval_t));
+
+    s->full->Push(f);
+
+    return SCH_OK;
+}
+
+void PipelineRunner::Stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_inputClosed.store(true, std::memory_order_release);
+    m_stages[0]->full->Wake();
+    for (size_t k = 0; k < m_threads.size(); ++k) {
+        m_threads[k].join();
+    }
+    m_threads.clear();
+    m_running = false;
+}
+
+bool PipelineRunner::Running() const
+{
+    return m_running;
+}
+
+size_t PipelineRunner::NumStages() const
+{
+    return m_stages.size();
+}
+
+size_t PipelineRunner::QueueDepth(size_t stage) const
+{
+    if (stage >= m_stages.size() || NULL == m_stages[stage]->full) {
+        return 0;
+    }
+    return m_stages[stage]->full->Size();
+}
+
+PipelineRunner::StageStats PipelineRunner::Stats(size_t stage) const
+{
+    StageStats st = StageStats();
+    if (stage >= m_stages.size()) {
+        return st;
+    }
+
+    const Stage *s = m_stages[stage];
+    st.id = s->module->Id();
+    st.capacity = m_ringSize;
+    st.depth = QueueDepth(stage);
+    st.maxDepth = s->maxDepth.load();
+    st.blocks = s->blocks.load();
+    st.meanDepth = st.blocks == 0
+        ? 0.0
+        : static_cast<double>(s->depthSum.load()) / st.blocks;
+
+    return st;
+}
+
+/*
+ * Per-stage thread. Take a block from the input ring, have the module write
+ * into a free frame of the next link, hand that frame downstream and give
+ * the input frame back upstream. Runs until the upstream side has finished
+ * and the input ring is empty. Waits on an empty or full ring sleep after a
+ * short spin, so an idle pipeline does not hold a core per stage.
+ */
+void PipelineRunner::stageLoop(size_t k)
+{
+    Stage *s = m_stages[k];
+    Stage *next = (k + 1 < m_stages.size()) ? m_stages[k + 1] : NULL;
+    BaseModule *m = s->module;
+    const std::atomic<bool> &upstreamDone =
+        (k == 0) ? m_inputClosed : m_stages[k - 1]->done;
+
+    Frame in, out;
+    for (;;) {
+        size_t depth = s->full->Size();
+        if (!s->full->Pop(in, upstreamDone)) {
+            break;
+        }
+
+        s->blocks.fetch_add(1, std::memory_order_relaxed);
+        s->depthSum.fetch_add(depth, std::memory_order_relaxed);
+        if (depth > s->maxDepth.load(std::memory_order_relaxed)) {
+            s->maxDepth.store(depth, std::memory_order_relaxed);
+        }
+
+        if (NULL != next) {
+            next->free->Pop(out);
+            m->SwapOutFrame(out);
+        }
+
+        m->Process(in);
+
+        const BaseModule::BaseModuleVector &kids = m->Children();
+        for (size_t i = 0; i < kids.size(); ++i) {
+            if (NULL == next || kids[i] != next->module) {
+                kids[i]->Update(m->OutFrame());
+            }
+        }
+
+        if (NULL != next) {
+            m->SwapOutFrame(out);
+            next->full->Push(out);
+        }
+
+        s->free->Push(in);
+    }
+
+    s->done.store(true, std::memory_order_release);
+    if (NULL != next) {
+        next->full->Wake();
+    }
+}
+
+void PipelineRunner::clearRings()
+{
+    for (size_t k = 0; k < m_stages.size(); ++k) {
+        delete m_stages[k]->full;
+        delete m_stages[k]->free;
+        m_stages[k]->full = NULL;
+        m_stages[k]->free = NULL;
+    }
+}
+
+}; /* namespace libsch */
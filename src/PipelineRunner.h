@@ -0,0 +1,134 @@
+#ifndef PIPELINERUNNER_H_
+#define PIPELINERUNNER_H_
+
+#include "BaseModule.h"
+#include "BdTypes.h"
+#include "Export.h"
+#include "Frame.h"
+#include "SpscRing.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace libsch
+{
+    /*!
+    \class  PipelineRunner PipelineRunner.h
+
+    \brief  Runs a chain of BaseModules with one thread per stage, so that
+            consecutive blocks overlap across stages.
+
+    Stage k's module must be a child of stage k-1's module. While stage k
+    works on block N, stage k-1 is already working on block N+1.
+
+    Neighbouring stages are connected by two SpscRings of preallocated
+    Frames: a "full" ring carrying produced blocks downstream and a "free"
+    ring returning consumed ones upstream. Nothing is allocated or copied
+    between stages; the producing module writes straight into a ring frame
+    (see BaseModule::SwapOutFrame()) and the consumer reads it in place.
+    Only Push() copies, once, into the first stage's input frame.
+
+    Children of a stage that are not themselves the next stage are updated
+    inline on the stage's thread, as in BaseModule::Update(const Frame &).
+
+    Each stage records the depth of its input queue every time it takes a
+    block. A stage whose queue keeps running full is the bottleneck; the
+    stages behind it sit near zero.
+    */
+    class DllExport PipelineRunner
+    {
+    public:
+        /*!
+        \struct StageStats
+        \brief  Input queue statistics of one stage.
+        */
+        struct StageStats
+        {
+            std::string id;             //!< Id() of the stage's module.
+            size_t capacity;            //!< Size of the input ring.
+            size_t depth;               //!< Blocks queued right now.
+            size_t maxDepth;            //!< Most blocks ever seen queued.
+            double meanDepth;           //!< Mean queued blocks per processed block.
+            unsigned long long blocks;  //!< Blocks processed.
+        };
+
+        /*!
+        * \param ringSize Number of frames in flight between two stages.
+        */
+        explicit PipelineRunner(size_t ringSize = 4);
+        PipelineRunner(const PipelineRunner&) = delete;
+
+        //! Stops and joins the stage threads if still running.
+        ~PipelineRunner();
+
+        /*!
+        * \brief Append \c module as the next stage.
+        *
+        * \return SCH_ERR_ADD_CHILD if \c module is not a child of the
+        *         previous stage, SCH_ERR if the pipeline is running.
+        */
+        SCH_RESULT AddStage(BaseModule *module);
+
+        /*!
+        * \brief Preallocate the rings and start one thread per stage.
+        *
+        * Module data lengths must be set before Start() and not changed
+        * while running.
+        */
+        SCH_RESULT Start();
+
+        /*!
+        * \brief Feed one block to the first stage.
+        *
+        * Copies min(n, first stage InDataLength()) samples, the rest of the
+        * input frame is zero. Waits while the first stage's queue is full.
+        */
+        SCH_RESULT Push(const realval_t *data, size_t n);
+
+        /*!
+        * \brief Let every queued block drain through all stages, then join
+        *        the stage threads.
+        */
+        void Stop();
+
+        //! True between Start() and Stop().
+        bool Running() const;
+
+        size_t NumStages() const;
+
+        //! Blocks currently waiting in front of \c stage.
+        size_t QueueDepth(size_t stage) const;
+
+        //! Queue statistics of \c stage.
+        StageStats Stats(size_t stage) const;
+
+    private:
+        typedef SpscRing<Frame> FrameRing;
+
+        struct Stage
+        {
+            BaseModule *module;
+            FrameRing *full;                    //!< Blocks waiting for this stage.
+            FrameRing *free;                    //!< Consumed blocks going back upstream.
+            std::atomic<bool> done;             //!< Thread finished, full ring drained.
+            std::atomic<unsigned long long> blocks;
+            std::atomic<unsigned long long> depthSum;
+            std::atomic<size_t> maxDepth;
+        };
+
+        size_t m_ringSize;
+        std::vector<Stage*> m_stages;
+        std::vector<std::thread> m_threads;
+        std::atomic<bool> m_inputClosed;
+        bool m_running;
+
+        void stageLoop(size_t k);
+        void clearRings();
+
+    }; /* PipelineRunner */
+
+}; /* namespace libsch */
+
+#endif /* PIPELINERUNNER_H_ */
@@ -0,0 +1,170 @@
+#include "ResonatorModule.h"
+#include "BufferPool.h"
+#include "Common.h"
+#include "BlkDsp.h"
+
+#include <algorithm>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+
+namespace libsch{
+
+namespace
+{
+    //! Floats per cache line, every delay line starts on one.
+    const size_t LineAlign = BufferPool::Alignment/sizeof(float);
+
+    /*
+     * line[j] = a*line[j] + b*x[j] for j < m. The caller guarantees m <= T,
+     * so no element is read after it has been written in this call.
+     */
+    inline void combChunk(float *line, const float *x, size_t m, float a, float b)
+    {
+        size_t j = 0;
+#if defined(__SSE__)
+        __m128 va = _mm_set1_ps(a);
+        __m128 vb = _mm_set1_ps(b);
+        for (; j+4 <= m; j += 4)
+        {
+            __m128 y = _mm_add_ps(_mm_mul_ps(va, _mm_loadu_ps(line+j)),
+                                  _mm_mul_ps(vb, _mm_loadu_ps(x+j)));
+            _mm_storeu_ps(line+j, y);
+        }
+#endif
+        for (; j < m; ++j)
+        {
+            line[j] = a*line[j] + b*x[j];
+        }
+    }
+}
+
+
+ResonatorModule::ResonatorModule(size_t datalength, size_t numBands, double envRate,
+                                 const std::string &id, BaseModule *parent,
+                                 size_t numResonators, double minBpm,
+                                 double maxBpm, double halfLife)
+    : BaseModule(numBands*datalength, numResonators, id, parent)
+    , m_dataLength(datalength)
+    , m_numBands(numBands)
+    , m_envRate(envRate)
+    , m_lastEnv(numBands, 0.0f)
+    , m_lines(NULL)
+    , m_bandStride(0)
+    , m_work(NULL)
+{
+    //Tempo candidates evenly spaced in delay, slowest first. Spacing them in
+    //bpm and rounding to whole samples would give many equal delays.
+    size_t minT = std::max<size_t>(1, static_cast<size_t>(ceil(60.0*envRate/maxBpm)));
+    size_t maxT = std::max(minT, static_cast<size_t>(floor(60.0*envRate/minBpm)));
+    size_t count = std::max<size_t>(1, std::min(numResonators, maxT - minT + 1));
+
+    size_t offset = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+        size_t T = (count > 1)
+            ? maxT - static_cast<size_t>(double(maxT - minT)*k/(count-1) + 0.5)
+            : maxT;
+
+        m_delay.push_back(T);
+        m_feedback.push_back(static_cast<float>(pow(0.5, T/(halfLife*envRate))));
+        m_offset.push_back(offset);
+        offset += (T + LineAlign-1)/LineAlign*LineAlign;
+    }
+    m_bandStride = offset;
+    OutDataLength(count);
+
+    dbg_prt((std::string(__func__) + ": " + std::to_string(count) +
+                " resonators, delay lines: " + std::to_string(offset*numBands*sizeof(float)) +
+                " bytes").c_str());
+
+    m_lines = BufferPool::Instance().Acquire(m_bandStride*m_numBands);
+    m_work = BufferPool::Instance().Acquire(m_dataLength);
+    m_phase.resize(numBands*count);
+    Reset();
+}
+
+ResonatorModule::~ResonatorModule(void)
+{
+    BufferPool::Instance().Release(m_lines);
+    BufferPool::Instance().Release(m_work);
+}
+
+size_t ResonatorModule::NumResonators() const
+{
+    return m_delay.size();
+}
+
+double ResonatorModule::Bpm(size_t k) const
+{
+    return 60.0*m_envRate/m_delay[k];
+}
+
+size_t ResonatorModule::Delay(size_t k) const
+{
+    return m_delay[k];
+}
+
+double ResonatorModule::BestBpm() const
+{
+    size_t best = std::max_element(_outvec, _outvec + _outLength) - _outvec;
+    return Bpm(best);
+}
+
+void ResonatorModule::Reset()
+{
+    memset(m_lines, 0, m_bandStride*m_numBands*sizeof(float));
+    std::fill(m_phase.begin(), m_phase.end(), 0);
+    std::fill(m_lastEnv.begin(), m_lastEnv.end(), 0.0f);
+}
+
+void ResonatorModule::DoUpdate()
+{
+    const size_t n = m_dataLength;
+    const size_t nr = m_delay.size();
+
+    memset(_outvec, 0, nr*sizeof(float));
+
+    for (size_t b = 0; b < m_numBands; ++b)
+    {
+        //Half-wave rectified first difference of the band envelope.
+        const float *env = _invec + b*n;
+        float prev = m_lastEnv[b];
+        for (size_t i = 0; i < n; ++i)
+        {
+            float d = env[i] - prev;
+            m_work[i] = d > 0.0f ? d : 0.0f;
+            prev = env[i];
+        }
+        m_lastEnv[b] = prev;
+
+        float *lines = m_lines + b*m_bandStride;
+        size_t *phase = &m_phase[b*nr];
+        for (size_t k = 0; k < nr; ++k)
+        {
+            const size_t T = m_delay[k];
+            const float a = m_feedback[k];
+            float *line = lines + m_offset[k];
+            size_t p = phase[k];
+
+            //Split the block where the circular line wraps.
+            for (size_t i = 0; i < n; )
+            {
+                size_t m = std::min(T - p, n - i);
+                combChunk(line + p, m_work + i, m, a, 1.0f - a);
+                p += m;
+                i += m;
+                if (p == T) p = 0;
+            }
+            phase[k] = p;
+
+            //The line holds the last beat period of output.
+            _outvec[k] += icstdsp::BlkDsp::power(line, static_cast<int>(T));
+        }
+    }
+}
+
+
+} /*namespace libsch*/
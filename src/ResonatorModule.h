@@ -0,0 +1,100 @@
+#ifndef RESONATORMODULE_H_
+#define RESONATORMODULE_H_
+
+#include "Export.h"
+#include "BaseModule.h"
+
+#include <vector>
+
+namespace libsch
+{
+    /*!
+     * \class   ResonatorModule ResonatorModule.h
+     * \brief   Scheirer's comb filter resonator bank, estimates tempo from
+     *          band envelopes.
+     *
+     *          The input is \c numBands band-major envelopes of \c datalength
+     *          samples each (one band straight from an ExtractorModule, or
+     *          several), at \c envRate Hz. Decimate the envelopes first: the
+     *          delay lines hold one beat period each, so their size grows
+     *          with the envelope rate.
+     *
+     *          Every band envelope is differentiated and half-wave rectified,
+     *          then fed to a bank of comb filters
+     *                 y[n] = a*y[n-T] + (1-a)*x[n]
+     *          with a chosen so that the impulse response of every resonator
+     *          decays to half in \c halfLife seconds. There is one resonator
+     *          per whole delay T between one beat at \c maxBpm and one at
+     *          \c minBpm, or \c numResonators delays evenly spaced over that
+     *          range if there are more; no two resonators share a delay.
+     *
+     *          Each delay line is a circular buffer of exactly T samples in
+     *          one contiguous, cache aligned arena. Since y[n] only reads
+     *          y[n-T], up to T consecutive samples of one resonator are
+     *          independent and are computed with SIMD along time over the
+     *          contiguous line. The line then holds the last beat period of
+     *          output, and its mean square is read once per block instead of
+     *          accumulating energy every sample.
+     *
+     *          The output is the tempo energy vector: NumResonators() values,
+     *          summed over bands, for the tempi given by Bpm().
+     */
+    class DllExport ResonatorModule : public BaseModule
+    {
+
+    public:
+        /*!
+         * \param datalength    Envelope samples per band and block.
+         * \param numBands      Bands in the input.
+         * \param envRate       Envelope sample rate in Hz.
+         * \param id
+         * \param parent
+         * \param numResonators Most tempo candidates, see NumResonators().
+         * \param minBpm        Slowest tempo candidate.
+         * \param maxBpm        Fastest tempo candidate.
+         * \param halfLife      Resonator impulse response half life in seconds.
+         */
+        ResonatorModule(size_t datalength, size_t numBands, double envRate,
+                        const std::string &id, BaseModule *parent=0,
+                        size_t numResonators=150, double minBpm=60.0,
+                        double maxBpm=240.0, double halfLife=1.5);
+        ~ResonatorModule(void);
+
+        //! Tempo candidates, at most the number of whole delays in the range.
+        size_t NumResonators() const;
+
+        //! Tempo of resonator \c k in beats per minute.
+        double Bpm(size_t k) const;
+
+        //! Delay of resonator \c k in envelope samples.
+        size_t Delay(size_t k) const;
+
+        //! Tempo of the resonator with the most energy after the last block.
+        double BestBpm() const;
+
+        //! Clear all delay lines.
+        void Reset();
+
+    protected:
+        virtual void DoUpdate() override;
+
+    private:
+        size_t m_dataLength;
+        size_t m_numBands;
+        double m_envRate;
+
+        std::vector<size_t> m_delay;        //!< T per resonator.
+        std::vector<float>  m_feedback;     //!< a per resonator.
+        std::vector<size_t> m_offset;       //!< Line start in m_lines, per resonator.
+        std::vector<size_t> m_phase;        //!< n mod T, per band and resonator.
+        std::vector<float>  m_lastEnv;      //!< Previous envelope sample, per band.
+
+        //! All delay lines, band-major, each starting on a cache line.
+        float *m_lines;
+        size_t m_bandStride;
+        //! Rectified difference of one band.
+        float *m_work;
+    };
+
+}
+#endif /* RESONATORMODULE_H_ */
@@ -0,0 +1,274 @@
+#ifndef SPSCRING_H_
+#define SPSCRING_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+namespace libsch
+{
+    /*!
+    \class  SpscRing SpscRing.h
+
+    \brief  Bounded lock-free single-producer/single-consumer ring.
+
+    The slots are allocated once, up front. Items move in and out by
+    swapping with the caller's object, so a ring of Frames hands storage
+    back and forth without allocating or touching reference counts.
+
+    Exactly one thread may push and exactly one (other) thread may pop.
+
+    TryPush() and TryPop() never block. Push() and Pop() spin on them for
+    a short while and then sleep until the other side has made room or
+    queued an item. The other side only takes the lock when somebody is
+    actually asleep, so the lock-free path stays lock-free.
+    */
+    template<class T>
+    class SpscRing
+    {
+    public:
+        /*!
+        * \param capacity Maximum number of items held at once.
+        */
+        explicit SpscRing(size_t capacity);
+        SpscRing(const SpscRing&) = delete;
+
+        /*!
+        * \brief Swap \c item into the ring.
+        * \return false if the ring is full, \c item is unchanged then.
+        */
+        bool TryPush(T &item);
+
+        /*!
+        * \brief Swap the oldest item out of the ring into \c item.
+        * \return false if the ring is empty, \c item is unchanged then.
+        */
+        bool TryPop(T &item);
+
+        //! Swap \c item into the ring, waits while the ring is full.
+        void Push(T &item);
+
+        //! Swap the oldest item out of the ring, waits while it is empty.
+        void Pop(T &item);
+
+        /*!
+        * \brief Like Pop(), but gives up once \c closed is set and the ring
+        *        is empty.
+        *
+        * The producer must push its last item before setting \c closed, and
+        * call Wake() after setting it.
+        * \return false if the ring was closed and empty.
+        */
+        bool Pop(T &item, const std::atomic<bool> &closed);
+
+        //! Wake a thread sleeping in Push() or Pop() to re-check its condition.
+        void Wake();
+
+        //! Number of items currently queued (a snapshot).
+        size_t Size() const;
+
+        //! Maximum number of items held at once.
+        size_t Capacity() const;
+
+    private:
+        //! Failed tries before Push() and Pop() go to sleep.
+        static const int SpinCount = 512;
+
+        std::vector<T> m_slots;
+
+        // The padding keeps head and tail on separate cache lines without
+        // over-aligning the ring, so it can be allocated with plain new.
+
+        //! Next slot to read, written by the consumer only.
+        std::atomic<size_t> m_head;
+        char m_headPad[64];
+        //! Next slot to write, written by the producer only.
+        std::atomic<size_t> m_tail;
+        char m_tailPad[64];
+
+        //! Threads sleeping in Push() or Pop().
+        std::atomic<int> m_sleepers;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+
+        inline size_t next(size_t i) const;
+        inline bool push(T &item);
+        inline bool pop(T &item);
+        inline void notify();
+
+    }; /* SpscRing */
+
+
+
+    /************************************************************************/
+    /*       TEMPLATE DEFINITIONS                                           */
+    /************************************************************************/
+
+    template<class T>
+    SpscRing<T>::SpscRing(size_t capacity)
+        : m_slots(capacity + 1)
+        , m_head(0)
+        , m_tail(0)
+        , m_sleepers(0)
+    { }
+
+    template<class T>
+    inline size_t SpscRing<T>::next(size_t i) const
+    {
+        return (i + 1 == m_slots.size()) ? 0 : i + 1;
+    }
+
+    template<class T>
+    inline bool SpscRing<T>::push(T &item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t n = next(tail);
+        if (n == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        using std::swap;
+        swap(m_slots[tail], item);
+        m_tail.store(n, std::memory_order_release);
+        return true;
+    }
+
+    template<class T>
+    inline bool SpscRing<T>::pop(T &item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        using std::swap;
+        swap(m_slots[head], item);
+        m_head.store(next(head), std::memory_order_release);
+        return true;
+    }
+
+    /*
+     * Pairs with the fence in Push()/Pop(): either the sleeper sees the index
+     * just stored, or this side sees the sleeper and wakes it.
+     */
+    template<class T>
+    inline void SpscRing<T>::notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleepers.load(std::memory_order_relaxed) > 0) {
+            Wake();
+        }
+    }
+
+    template<class T>
+    bool SpscRing<T>::TryPush(T &item)
+    {
+        if (!push(item)) {
+            return false;
+        }
+        notify();
+        return true;
+    }
+
+    template<class T>
+    bool SpscRing<T>::TryPop(T &item)
+    {
+        if (!pop(item)) {
+            return false;
+        }
+        notify();
+        return true;
+    }
+
+    template<class T>
+    void SpscRing<T>::Push(T &item)
+    {
+        for (int i = 0; i < SpinCount; ++i) {
+            if (TryPush(item)) {
+                return;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!push(item)) {
+            m_wake.wait(lock);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        lock.unlock();
+
+        notify();
+    }
+
+    template<class T>
+    void SpscRing<T>::Pop(T &item)
+    {
+        const std::atomic<bool> open(false);
+        Pop(item, open);
+    }
+
+    template<class T>
+    bool SpscRing<T>::Pop(T &item, const std::atomic<bool> &closed)
+    {
+        for (int i = 0; i < SpinCount; ++i) {
+            if (TryPop(item)) {
+                return true;
+            }
+            // The last item was pushed before the flag was set, so an empty
+            // ring after seeing the flag is final.
+            if (closed.load(std::memory_order_acquire)) {
+                return TryPop(item);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool popped;
+        for (;;) {
+            if ((popped = pop(item))) {
+                break;
+            }
+            if (closed.load(std::memory_order_acquire)) {
+                popped = pop(item);
+                break;
+            }
+            m_wake.wait(lock);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        lock.unlock();
+
+        if (popped) {
+            notify();
+        }
+        return popped;
+    }
+
+    template<class T>
+    void SpscRing<T>::Wake()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_all();
+    }
+
+    template<class T>
+    size_t SpscRing<T>::Size() const
+    {
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        return (tail >= head) ? tail - head : tail + m_slots.size() - head;
+    }
+
+    template<class T>
+    size_t SpscRing<T>::Capacity() const
+    {
+        return m_slots.size() - 1;
+    }
+
+}; /* namespace libsch */
+
+#endif /* SPSCRING_H_ */
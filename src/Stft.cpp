@@ -0,0 +1,207 @@
+/*
+ * Stft.cpp
+ *
+ *  Streaming short-time Fourier transform.
+ */
+
+#include "Stft.h"
+
+#include "Common.h"
+#include "BlkDsp.h"
+#include "prt_dbg.h"
+
+#include <string>
+#include <string.h>
+
+
+namespace libsch
+{
+
+using icstdsp::BlkDsp;
+
+
+Stft::Stft(size_t fftLength, size_t hop, size_t capacity, Window window, Output output)
+    : m_fftLength(BlkDsp::nexthipow2(static_cast<int>(fftLength < 4 ? 4 : fftLength)))
+    , m_hop(hop)
+    , m_capacity(capacity < 1 ? 1 : capacity)
+    , m_output(output)
+{
+    if (m_hop < 1 || m_hop > m_fftLength)
+    {
+        dbg_prt((std::string(__func__) + " Hop " + std::to_string(hop) +
+                    " out of range, using " + std::to_string(m_fftLength/2) + ".").c_str());
+        m_hop = m_fftLength/2;
+    }
+
+    int n = static_cast<int>(m_fftLength);
+    m_window = BlkDsp::sseallocf(n);
+    m_input = BlkDsp::sseallocf(2*n);
+    m_frames = BlkDsp::sseallocf(n*static_cast<int>(m_capacity));
+
+    // Periodic windows: the first n points of a symmetric n+1 point window.
+    float *tmp = BlkDsp::sseallocf(n+1);
+    switch (window)
+    {
+    case STFT_HANN:     BlkDsp::hann(tmp, n+1);     break;
+    case STFT_HAMMING:  BlkDsp::hamming(tmp, n+1);  break;
+    case STFT_BLACKMAN: BlkDsp::blackman(tmp, n+1); break;
+    default:            BlkDsp::set(tmp, 1.0f, n+1); break;
+    }
+    BlkDsp::copy(m_window, tmp, n);
+    BlkDsp::ssefree(tmp);
+
+    Reset();
+}
+
+Stft::~Stft()
+{
+    BlkDsp::ssefree(m_window);
+    BlkDsp::ssefree(m_input);
+    BlkDsp::ssefree(m_frames);
+}
+
+void Stft::Reset()
+{
+    BlkDsp::set(m_input, 0, 2*static_cast<int>(m_fftLength));
+    m_write = 0;
+    m_untilFrame = m_fftLength;
+    m_head = 0;
+    m_count = 0;
+    m_frontIndex = 0;
+    m_dropped = 0;
+}
+
+/*
+ * Copy in runs that stop at the end of the circular buffer or at the next
+ * frame boundary, whichever comes first. After a frame boundary the
+ * oldest sample of the window sits at m_write.
+ */
+size_t Stft::Push(const float *in, size_t n)
+{
+    const size_t N = m_fftLength;
+    size_t frames = 0;
+
+    while (n > 0)
+    {
+        size_t m = n;
+        if (m > m_untilFrame) m = m_untilFrame;
+        if (m > N - m_write) m = N - m_write;
+
+        memcpy(m_input + m_write, in, m*sizeof(float));
+        memcpy(m_input + m_write + N, in, m*sizeof(float));
+        m_write += m;
+        if (m_write == N) m_write = 0;
+        m_untilFrame -= m;
+        in += m;
+        n -= m;
+
+        if (m_untilFrame == 0)
+        {
+            emit(m_input + m_write);
+            m_untilFrame = m_hop;
+            ++frames;
+        }
+    }
+
+    return frames;
+}
+
+void Stft::emit(const float *src)
+{
+    int n = static_cast<int>(m_fftLength);
+
+    size_t slot = m_head + m_count;
+    if (slot >= m_capacity) slot -= m_capacity;
+    if (m_count == m_capacity)
+    {
+        // Reader fell behind, overwrite the oldest frame.
+        if (++m_head == m_capacity) m_head = 0;
+        ++m_frontIndex;
+        ++m_dropped;
+    }
+    else
+    {
+        ++m_count;
+    }
+
+    float *d = m_frames + slot*m_fftLength;
+    BlkDsp::copy(d, const_cast<float*>(src), n);
+    BlkDsp::mul(d, m_window, n);
+    BlkDsp::realfft(d, n);
+
+    if (m_output == STFT_COMPLEX) return;
+
+    // Packed format keeps the Nyquist bin in [1], move it to the end.
+    float nyq = d[1];
+    d[1] = 0;
+    if (m_output == STFT_MAGNITUDE) {
+        BlkDsp::cpxmag(d, d, n/2);
+        d[n/2] = fabsf(nyq);
+    } else {
+        BlkDsp::cpxpow(d, d, n/2);
+        d[n/2] = nyq*nyq;
+    }
+}
+
+size_t Stft::Available() const
+{
+    return m_count;
+}
+
+const float* Stft::Front() const
+{
+    return Peek(0);
+}
+
+const float* Stft::Peek(size_t i) const
+{
+    if (i >= m_count) return NULL;
+    size_t slot = m_head + i;
+    if (slot >= m_capacity) slot -= m_capacity;
+    return m_frames + slot*m_fftLength;
+}
+
+void Stft::Pop(size_t n)
+{
+    if (n > m_count) n = m_count;
+    m_head = (m_head + n) % m_capacity;
+    m_count -= n;
+    m_frontIndex += n;
+}
+
+size_t Stft::FrontIndex() const
+{
+    return m_frontIndex;
+}
+
+size_t Stft::Dropped() const
+{
+    return m_dropped;
+}
+
+size_t Stft::FftLength() const
+{
+    return m_fftLength;
+}
+
+size_t Stft::Hop() const
+{
+    return m_hop;
+}
+
+size_t Stft::Capacity() const
+{
+    return m_capacity;
+}
+
+size_t Stft::FrameLength() const
+{
+    return (m_output == STFT_COMPLEX) ? m_fftLength : m_fftLength/2 + 1;
+}
+
+const float* Stft::WindowData() const
+{
+    return m_window;
+}
+
+}; /* namespace libsch */
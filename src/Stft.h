@@ -0,0 +1,138 @@
+#ifndef STFT_H_
+#define STFT_H_
+
+#include "Export.h"
+
+#include <stddef.h>
+
+namespace libsch
+{
+    /*!
+    \class  Stft Stft.h
+
+    \brief  Streaming short-time Fourier transform.
+
+    Push() accepts any number of samples. Every \c hop samples, once the
+    first FftLength() samples have arrived, the last FftLength() samples
+    are windowed, transformed with BlkDsp::realfft and written into a ring
+    of Capacity() preallocated frames. Frame k covers input samples
+    [k*hop, k*hop + FftLength()).
+
+    The input is kept in a mirrored circular buffer (every sample stored
+    twice, FftLength() apart), so the current window is always contiguous
+    and advancing by one hop costs O(hop) instead of shifting the whole
+    history. The window is computed once per object. Nothing is allocated
+    after construction.
+
+    Frames are read oldest first with Front()/Peek() and released with
+    Pop(). If the reader falls behind, the oldest frame is overwritten and
+    counted in Dropped().
+
+    Frame layout depends on Output:
+    - STFT_COMPLEX: FftLength() floats in realfft's packed format,
+    - STFT_MAGNITUDE, STFT_POWER: FftLength()/2+1 floats, bin 0 to Nyquist,
+      the lower half spectrum expected by e.g. AudioAnalysis::spectralflux.
+    */
+    class DllExport Stft
+    {
+    public:
+        /*!
+        * \enum  Window
+        * \brief Analysis window. Hann, Hamming and Blackman are periodic.
+        */
+        enum Window
+        {
+            STFT_RECT,
+            STFT_HANN,
+            STFT_HAMMING,
+            STFT_BLACKMAN
+        };
+
+        /*!
+        * \enum  Output
+        * \brief What a frame holds.
+        */
+        enum Output
+        {
+            STFT_COMPLEX,       //!< Packed complex half spectrum.
+            STFT_MAGNITUDE,     //!< |X[k]|
+            STFT_POWER          //!< |X[k]|^2
+        };
+
+        /*!
+        * \param fftLength Frame length, rounded up to a power of 2.
+        * \param hop       Samples between frames, 1..fftLength.
+        * \param capacity  Frames in the ring.
+        * \param window
+        * \param output
+        */
+        Stft(size_t fftLength, size_t hop, size_t capacity=8,
+             Window window=STFT_HANN, Output output=STFT_MAGNITUDE);
+        Stft(const Stft&) = delete;
+        Stft& operator=(const Stft&) = delete;
+        ~Stft();
+
+        /*!
+        * \brief Append \c n input samples.
+        * \return Number of frames completed by this call.
+        */
+        size_t Push(const float *in, size_t n);
+
+        //! Frames waiting to be read.
+        size_t Available() const;
+
+        //! Oldest unread frame, NULL if none.
+        const float* Front() const;
+
+        //! The \c i-th unread frame, 0 is the oldest. NULL if i >= Available().
+        const float* Peek(size_t i) const;
+
+        //! Release the \c n oldest unread frames.
+        void Pop(size_t n=1);
+
+        //! Frame number of Front(), counted from the start of the stream.
+        size_t FrontIndex() const;
+
+        //! Frames overwritten before they were read.
+        size_t Dropped() const;
+
+        //! Forget the input and all frames, as if the stream started over.
+        void Reset();
+
+        size_t FftLength() const;
+        size_t Hop() const;
+        size_t Capacity() const;
+
+        //! Floats per frame, see class description.
+        size_t FrameLength() const;
+
+        //! The FftLength() window samples.
+        const float* WindowData() const;
+
+    private:
+        size_t m_fftLength;
+        size_t m_hop;
+        size_t m_capacity;
+        Output m_output;
+
+        float *m_window;
+        //! Mirrored input: sample i is at [i mod N] and [i mod N + N].
+        float *m_input;
+        size_t m_write;
+        //! Samples still missing before the next frame.
+        size_t m_untilFrame;
+
+        //! Capacity() frames of FftLength() floats each.
+        float *m_frames;
+        size_t m_head;
+        size_t m_count;
+        size_t m_frontIndex;
+        size_t m_dropped;
+
+        void emit(const float *src);
+
+    }; /* Stft */
+
+}; /* namespace libsch */
+
+#endif /* STFT_H_ */
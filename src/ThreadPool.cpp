@@ -0,0 +1,180 @@
+/*
+ * ThreadPool.cpp
+ *
+ *  Work-stealing pool used by the module graph executors.
+ */
+
+#include "ThreadPool.h"
+#include "prt_dbg.h"
+
+
+namespace libsch
+{
+
+namespace
+{
+    //! Index of the pool queue owned by the current thread, -1 outside a pool.
+    thread_local int t_queueIndex = -1;
+    thread_local const ThreadPool *t_pool = NULL;
+}
+
+ThreadPool::ThreadPool(unsigned int maxThreads)
+    : m_pending(0)
+    , m_queued(0)
+    , m_nextQueue(0)
+    , m_stop(false)
+    , m_waiters(0)
+{
+    if (maxThreads == 0) {
+        maxThreads = std::thread::hardware_concurrency();
+    }
+    if (maxThreads == 0) {
+        maxThreads = 1;
+    }
+
+    dbg_prt(("ThreadPool: starting " + std::to_string(maxThreads) + " workers").c_str());
+
+    for (unsigned int i = 0; i < maxThreads; ++i) {
+        m_queues.push_back(new Queue);
+    }
+    for (unsigned int i = 0; i < maxThreads; ++i) {
+        m_threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    Wait();
+    {
+        std::lock_guard<std::mutex> l(m_sleepLock);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto &t : m_threads) {
+        t.join();
+    }
+    for (auto q : m_queues) {
+        delete q;
+    }
+}
+
+void ThreadPool::Submit(const Task &task)
+{
+    size_t qi;
+    if (t_pool == this && t_queueIndex >= 0) {
+        qi = static_cast<size_t>(t_queueIndex);
+    } else {
+        qi = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    }
+
+    m_pending.fetch_add(1, std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> l(m_queues[qi]->lock);
+        m_queues[qi]->tasks.push_back(task);
+    }
+    bool waiting;
+    {
+        std::lock_guard<std::mutex> l(m_sleepLock);
+        m_queued.fetch_add(1, std::memory_order_release);
+        waiting = m_waiters > 0;
+    }
+    m_wake.notify_one();
+    // A thread in Wait() helps with tasks submitted while it sleeps, too.
+    if (waiting) {
+        m_done.notify_all();
+    }
+}
+
+void ThreadPool::Wait()
+{
+    int self = (t_pool == this) ? t_queueIndex : 0;
+    Task task;
+    while (m_pending.load(std::memory_order_acquire) > 0) {
+        if (pop(static_cast<size_t>(self), task)) {
+            run(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> l(m_sleepLock);
+        ++m_waiters;
+        m_done.wait(l, [this] {
+            return m_pending.load(std::memory_order_acquire) == 0
+                || m_queued.load(std::memory_order_acquire) > 0;
+        });
+        --m_waiters;
+    }
+}
+
+unsigned int ThreadPool::NumThreads() const
+{
+    return static_cast<unsigned int>(m_threads.size());
+}
+
+/*
+ * Take a task from the back of our own queue, or steal one from the front
+ * of somebody else's.
+ */
+bool ThreadPool::pop(size_t self, Task &task)
+{
+    size_t n = m_queues.size();
+    {
+        Queue *q = m_queues[self];
+        std::lock_guard<std::mutex> l(q->lock);
+        if (! q->tasks.empty()) {
+            task = std::move(q->tasks.back());
+            q->tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    for (size_t i = 1; i < n; ++i) {
+        Queue *q = m_queues[(self + i) % n];
+        std::lock_guard<std::mutex> l(q->lock);
+        if (! q->tasks.empty()) {
+            task = std::move(q->tasks.front());
+            q->tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Run and destroy the task before it is counted as finished, so anything it
+ * captured is released by the time Wait() returns.
+ */
+void ThreadPool::run(Task &task)
+{
+    task();
+    task = nullptr;
+
+    if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> l(m_sleepLock);
+        m_done.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop(size_t self)
+{
+    t_pool = this;
+    t_queueIndex = static_cast<int>(self);
+
+    Task task;
+    for (;;) {
+        if (pop(self, task)) {
+            run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> l(m_sleepLock);
+        m_wake.wait(l, [this] {
+            return m_stop || m_queued.load(std::memory_order_acquire) > 0;
+        });
+        if (m_stop && m_queued.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+}; /* namespace libsch */
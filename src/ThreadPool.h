@@ -0,0 +1,89 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include "Export.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libsch
+{
+    /*!
+    \class  ThreadPool ThreadPool.h
+
+    \brief  A small work-stealing thread pool.
+
+    Every worker owns a task deque. Tasks submitted from a worker go to the
+    back of that worker's own deque and are popped from the back again
+    (depth first, cache warm); idle workers steal from the front of the
+    other deques. Tasks submitted from outside the pool are spread round
+    robin over the workers.
+
+    Wait() blocks until every submitted task has finished. The waiting
+    thread runs queued tasks itself before it goes to sleep.
+    */
+    class DllExport ThreadPool
+    {
+    public:
+        /*!
+        * \typedef typedef std::function<void()> Task;
+        * \brief A unit of work for the pool.
+        */
+        typedef std::function<void()> Task;
+
+        /*!
+        * \brief Start the worker threads.
+        *
+        * \param maxThreads Number of workers, 0 uses
+        *        std::thread::hardware_concurrency().
+        */
+        explicit ThreadPool(unsigned int maxThreads = 0);
+        ThreadPool(const ThreadPool&) = delete;
+        ~ThreadPool();
+
+        //! Queue \c task for execution.
+        void Submit(const Task &task);
+
+        //! Block until all submitted tasks are finished, helping out meanwhile.
+        void Wait();
+
+        //! Number of worker threads.
+        unsigned int NumThreads() const;
+
+    private:
+        struct Queue
+        {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<Queue*>      m_queues;
+        std::vector<std::thread> m_threads;
+
+        //! Tasks submitted but not finished.
+        std::atomic<int>         m_pending;
+        //! Tasks sitting in a queue. Only incremented under m_sleepLock.
+        std::atomic<int>         m_queued;
+        std::atomic<unsigned int> m_nextQueue;
+        bool                     m_stop;
+        //! Threads asleep in Wait(). Guarded by m_sleepLock.
+        int                      m_waiters;
+
+        std::mutex               m_sleepLock;
+        std::condition_variable  m_wake;
+        std::condition_variable  m_done;
+
+        bool pop(size_t self, Task &task);
+        void run(Task &task);
+        void workerLoop(size_t self);
+
+    }; /* ThreadPool */
+
+}; /* namespace libsch */
+
+#endif /* THREADPOOL_H_ */
@@ -9,6 +9,7 @@
 #include "MathDefs.h"
 #include "BlkDsp.h"
 #include "SpecMath.h"
+#include "CpuDispatch.h"
 
 namespace icstdsp {		// begin library specific namespace
 
@@ -821,6 +822,63 @@ void AudioAnalysis::envelope(float* d, float* r, float &c, int size,
 #endif
 }
 
+// multi-channel envelope follower
+// input:	interleaved signal d[0..size*lanes-1], continuation data c[0..lanes-1]
+//			atime/rtime[0..lanes-1]: per lane attack/release time constants
+//			envelope type: 0 absolute value, 1 power, 2 RMS 
+// output:	interleaved envelope r[0..size*lanes-1], continuation data c
+void AudioAnalysis::envelope(float* d, float* r, float* c, int size, int lanes,
+							 float* atime, float* rtime, int type)
+{
+	kernels().envelope(d, r, c, size, lanes, lanes, atime, rtime, type);
+}
+
+// SSE2 version: 4 lanes per register, sample i of lane l at d[i*stride+l]
+void sse2::envelope(float* d, float* r, float* c, int size, int lanes,
+					int stride, float* atime, float* rtime, int type)
+{
+	int i,l=0; float x,a,rt,cc;
+	float adn = (type >= 2) ? ANTI_DENORMAL_FLOAT*ANTI_DENORMAL_FLOAT : ANTI_DENORMAL_FLOAT;
+
+#ifndef ICSTLIB_NO_SSEOPT
+	const __m128 sgn = _mm_set1_ps(-0.0f);
+	const __m128 sadn = _mm_set1_ps(adn);
+	for (; l+4 <= lanes; l+=4) {						// 4 lanes per register
+		ICSTDSP_SSEALIGN float ta[4], tr[4];
+		for (i=0; i<4; i++) {							// 1-exp(-1/time) approx.
+			ta[i] = 1.0f/__max(1.0f,atime[l+i]);
+			tr[i] = 1.0f/__max(1.0f,rtime[l+i]);
+		}
+		__m128 sa = _mm_load_ps(ta), sr = _mm_load_ps(tr);
+		__m128 sc = _mm_loadu_ps(c+l), sx, sm, sk;
+		for (i=0; i<size; i++) {
+			sx = _mm_loadu_ps(d+i*stride+l);
+			if (type == 0) {sx = _mm_andnot_ps(sgn,sx);}
+			else {sx = _mm_mul_ps(sx,sx);}
+			sx = _mm_add_ps(sx,sadn);
+			sm = _mm_cmpgt_ps(sx,sc);
+			sk = _mm_or_ps(_mm_and_ps(sm,sa),_mm_andnot_ps(sm,sr));
+			sc = _mm_add_ps(sc,_mm_mul_ps(sk,_mm_sub_ps(sx,sc)));
+			if (type >= 2) {_mm_storeu_ps(r+i*stride+l,_mm_sqrt_ps(sc));}
+			else {_mm_storeu_ps(r+i*stride+l,sc);}
+		}
+		_mm_storeu_ps(c+l,sc);
+	}
+#endif
+	for (; l<lanes; l++) {								// remaining lanes
+		a = 1.0f/__max(1.0f,atime[l]);
+		rt = 1.0f/__max(1.0f,rtime[l]);
+		cc = c[l];
+		for (i=0; i<size; i++) {
+			x = d[i*stride+l];
+			x = ((type == 0) ? fabsf(x) : x*x) + adn;
+			if (x > cc) {cc += (a*(x - cc));} else {cc += (rt*(x - cc));}
+			r[i*stride+l] = (type >= 2) ? sqrtf(cc) : cc;
+		}
+		c[l] = cc;
+	}
+}
+
 // fundamental frequency detector based on normalized autocorrelation
 // input:	signal d[0..size-1], type = normalization scheme:
 //			0 McLeod/Wyvill (intended for musical applications)
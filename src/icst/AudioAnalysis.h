@@ -170,6 +170,18 @@ static void envelope(float* d, float* r, float &c, int size,
 static void oldenvelope(float* d, float* r, float &c, int size, 
 					 float atime=200.0f, float rtime=2000.0f, int type=0);
 
+// multi-channel envelope follower: lanes independent followers in parallel
+// input:	interleaved signal d[0..size*lanes-1], sample i of lane l at
+//			d[i*lanes+l], continuation data c[0..lanes-1]: init with 0
+//			atime/rtime[0..lanes-1]: attack/release time constants of each
+//			lane in sampling intervals
+//			envelope type: 0 absolute value, 1 power, 2 RMS
+// output:	interleaved envelope r[0..size*lanes-1], continuation data c
+// note:	runs 16 (AVX-512), 8 (AVX2) or 4 (SSE2) lanes per register,
+//			depending on the CPU, any lanes > 0 works
+static void envelope(float* d, float* r, float* c, int size, int lanes,
+					 float* atime, float* rtime, int type=0);
+
 // fundamental frequency detector based on normalized autocorrelation
 // input:	signal d[0..size-1], type = normalization scheme:
 //			0 McLeod/Wyvill (intended for musical applications)
@@ -7,9 +7,12 @@
 #include "Common.h"
 #include "CritSect.h"	// must not be included before "Common.h"
 #include "BlkDsp.h"
+#include "CpuDispatch.h"
+#include "FftSoa.h"
 #include "fftooura.h"
 #include "MathDefs.h"
 #include "SpecMath.h"
+#include <atomic>
 #include <climits>
 #include <algorithm>	// STL used for: "median()", "quantile()", "sort"
 #include <string.h>
@@ -22,9 +25,13 @@ namespace icstdsp {		// begin library specific namespace
 //******************************************************************************
 //* resources to speed up transforms
 //*
-#ifdef ICSTLIB_USE_IPP						
 namespace {								// begin anonymous namespace
 	const int FFTMAXORD = 14;			// prepare up to size = 2^FFTMAXORD
+	const float* soatwiddles(int m);	// s. batched FFT routines
+}										// end anonymous namespace
+
+#ifdef ICSTLIB_USE_IPP						
+namespace {								// begin anonymous namespace
 	static IppsFFTSpec_C_32fc** fftfSpec = NULL;	// (i)fft float
 	static IppsFFTSpec_C_64fc** fftdSpec = NULL;	// (i)fft double
 	static IppsFFTSpec_R_32f** rfftfSpec = NULL;	// real(i)fft float
@@ -39,10 +46,14 @@ namespace {								// begin anonymous namespace
 // preallocate resources to speed up transforms
 // call once during application initialization
 // call UnPrepareTransforms before the application terminates
-// effect on internal routines:	none
+// effect on internal routines:	build the twiddle tables of the batched FFT
+//								and Ooura's package up to size 2^FFTMAXORD
 // effect on external routines:	prepare IPP FFT
+// without it or beyond 2^FFTMAXORD the internal tables of a size are built on
+// its first use, from any thread, and then shared: lookups are lock-free
 void BlkDsp::PrepareTransforms()
 {
+	for (int j=1; j<=FFTMAXORD; j++) {soatwiddles(1<<(j-1));}
 #ifdef ICSTLIB_USE_IPP
 	int i; bool err = false;
 	if (fftfSpec) return;
@@ -93,12 +104,17 @@ void BlkDsp::PrepareTransforms()
 		err |= (idctdSpec[i] == NULL);
 	}
 	if (err) {UnPrepareTransforms();}
+#else
+	fftprepare(2<<FFTMAXORD, static_cast<float*>(NULL));	// cdft: 2*size
+	fftprepare(2<<FFTMAXORD, static_cast<double*>(NULL));	//
 #endif
 }
 
 // free resources allocated by PrepareTransforms
 // call before terminating the application if PrepareTransforms has ever
 // been called, has no effect if PrepareTransforms was never called
+// the internal tables are kept for the lifetime of the process, since
+// other threads may read them without locking
 void BlkDsp::UnPrepareTransforms()
 {
 #ifdef ICSTLIB_USE_IPP
@@ -319,6 +335,146 @@ void BlkDsp::realifft(double* d, int size)
 #endif
 }
 
+//******************************************************************************
+//* batched FFT routines, several frames are transformed in parallel SIMD lanes
+//*
+namespace {								// begin anonymous namespace
+	const int SOABLOCK = 16;			// frames per block of strided transforms
+
+	std::atomic<float*> soatab[32];		// twiddle tables per log2(m)
+
+	// compute twiddle factors for rfftsoa of size 2m, s. FftSoa.h
+	float* makesoatwiddles(int m)
+	{
+		int t, h = m>>1;
+		float* tw = new float[4*h + 2];
+		float* pw = tw + 2*h;
+		double a = M_PI/static_cast<double>(m);
+		for (t=0; t<h; t++) {
+			tw[2*t] = static_cast<float>(cos(2.0*a*static_cast<double>(t)));
+			tw[2*t+1] = static_cast<float>(-sin(2.0*a*static_cast<double>(t)));
+		}
+		for (t=0; t<=h; t++) {
+			pw[2*t] = static_cast<float>(cos(a*static_cast<double>(t)));
+			pw[2*t+1] = static_cast<float>(-sin(a*static_cast<double>(t)));
+		}
+		return tw;
+	}
+
+	// twiddle factors for rfftsoa of size 2m from the registry, built on first
+	// use: if several threads build the same size, one table is published and
+	// the others are freed, later lookups are a single atomic load
+	const float* soatwiddles(int m)
+	{
+		int l = 0;
+		while ((1 << l) < m) {l++;}
+		float* tw = soatab[l].load(std::memory_order_acquire);
+		if (tw != NULL) {return tw;}
+		float* nw = makesoatwiddles(m);
+		if (soatab[l].compare_exchange_strong(tw, nw, std::memory_order_acq_rel,
+												std::memory_order_acquire)) {
+			return nw;
+		}
+		delete[] nw;
+		return tw;
+	}
+
+	// dst[c*dstride + r] = src[r*sstride + c], r < rows, c < cols
+	void transpose(float* dst, const float* src, int rows, int cols,
+					int dstride, int sstride)
+	{
+		int r=0,c;
+#ifndef ICSTLIB_NO_SSEOPT
+		__m128 x0,x1,x2,x3;
+		for (; r<=(rows-4); r+=4) {
+			const float* s = src + r*sstride;
+			float* d = dst + r;
+			for (c=0; c<=(cols-4); c+=4) {
+				x0 = _mm_loadu_ps(s+c);
+				x1 = _mm_loadu_ps(s+sstride+c);
+				x2 = _mm_loadu_ps(s+2*sstride+c);
+				x3 = _mm_loadu_ps(s+3*sstride+c);
+				_MM_TRANSPOSE4_PS(x0,x1,x2,x3);
+				_mm_storeu_ps(d+c*dstride, x0);
+				_mm_storeu_ps(d+(c+1)*dstride, x1);
+				_mm_storeu_ps(d+(c+2)*dstride, x2);
+				_mm_storeu_ps(d+(c+3)*dstride, x3);
+			}
+			for (; c<cols; c++) {
+				d[c*dstride] = s[c]; d[c*dstride+1] = s[sstride+c];
+				d[c*dstride+2] = s[2*sstride+c]; d[c*dstride+3] = s[3*sstride+c];
+			}
+		}
+#endif
+		for (; r<rows; r++) {
+			for (c=0; c<cols; c++) {dst[c*dstride+r] = src[r*sstride+c];}
+		}
+	}
+
+	// strided frames: transpose blocks of frames to SoA, transform, transpose back
+	void soastrided(float* d, int size, int frames, int stride, int dir)
+	{
+		int k,f,m = size>>1;
+		const float* tw = soatwiddles(m);
+		float* t = new float[size*SOABLOCK];
+		for (k=0; k<frames; k+=SOABLOCK) {
+			f = __min(SOABLOCK, frames-k);
+			transpose(t, d+k*stride, f, size, f, stride);
+			kernels().rfftsoa(t, m, f, tw, dir);
+			transpose(d+k*stride, t, size, f, stride, f);
+		}
+		delete[] t;
+	}
+}										// end anonymous namespace
+
+// batched FFT of real data. size is a power of 2.
+// frames: number of frames, each in the format of realfft
+// strided layout: frame k at d[k*stride..k*stride+size-1], stride >= size
+void BlkDsp::realfft(float* d, int size, int frames, int stride) {
+	soastrided(d, size, frames, stride, 1);}
+
+// batched IFFT to real data. size is a power of 2.
+// frames: number of frames, each in the format of realifft
+// strided layout: frame k at d[k*stride..k*stride+size-1], stride >= size
+void BlkDsp::realifft(float* d, int size, int frames, int stride) {
+	soastrided(d, size, frames, stride, -1);}
+
+// batched FFT of real data in structure of arrays layout. size is a power of 2.
+// sample i of frame k at d[i*frames+k], frame format as realfft
+void BlkDsp::realfftsoa(float* d, int size, int frames)
+{
+	kernels().rfftsoa(d, size>>1, frames, soatwiddles(size>>1), 1);
+}
+
+// batched IFFT to real data in structure of arrays layout. size is a power of 2.
+// sample i of frame k at d[i*frames+k], frame format as realifft
+void BlkDsp::realifftsoa(float* d, int size, int frames)
+{
+	kernels().rfftsoa(d, size>>1, frames, soatwiddles(size>>1), -1);
+}
+
+#ifndef ICSTLIB_NO_SSEOPT
+// vector class for the batched real FFT, s. FftSoa.h
+struct SoaSse
+{
+	typedef __m128 T;
+	enum {W = 4};
+	static T load(const float* p) {return _mm_loadu_ps(p);}
+	static void store(float* p, T x) {_mm_storeu_ps(p, x);}
+	static T set1(float c) {return _mm_set1_ps(c);}
+	static T add(T a, T b) {return _mm_add_ps(a, b);}
+	static T sub(T a, T b) {return _mm_sub_ps(a, b);}
+	static T mul(T a, T b) {return _mm_mul_ps(a, b);}
+	static T madd(T a, T b, T c) {return _mm_add_ps(_mm_mul_ps(a, b), c);}
+	static T msub(T a, T b, T c) {return _mm_sub_ps(_mm_mul_ps(a, b), c);}
+};
+#else
+typedef SoaScalar SoaSse;
+#endif
+
+void sse2::rfftsoa(float* d, int m, int f, const float* tw, int dir) {
+	soarfft<SoaSse>(d, m, f, tw, dir);}
+
 // FFT of symmetrical real data. size is a power of 2.
 // in:	d[] = re[0],re[1],..,re[size], contains lower half original data
 // out:	d[] = re[0],re[1],..,re[size], contains lower half spectrum
@@ -1063,13 +1219,8 @@ void BlkDsp::triangle(float* d, int size)
 void BlkDsp::trigwin2(float* d, int size, double c0, double c1)
 {
 	if (size == 1) {d[0] = static_cast<float>(c0 + c1); return;}
-	double temp = 2.0*M_PI/static_cast<double>(size-1);
-	double wre = cos(temp), wim = sin(temp);
-	double re=-1.0, im=0;
-	for (int i=0; i<=(size>>1); i++) {
-		d[size-i-1] = d[i] = static_cast<float>(c0 + c1*re);
-		temp = re; re = wre*re - wim*im; im = wre*im + wim*temp;
-	}
+	double p[2] = {c0, c1};
+	kernels().trigwin(d, size, p, 1);
 }
 
 // generic 4-term trigonometric window
@@ -1077,12 +1228,20 @@ void BlkDsp::trigwin4(	float* d, int size, double c0, double c1,
 						double c2, double c3						)
 {
 	if (size == 1) {d[0] = static_cast<float>(c0 + c1 + c2 + c3); return;}
-	c0 -= c2; c1 -= (3.0*c3); c2 *= 2.0; c3 *= 4.0;
+	double p[4] = {c0 - c2, c1 - 3.0*c3, 2.0*c2, 4.0*c3};
+	kernels().trigwin(d, size, p, 3);
+}
+
+// polynomial in cos(x), x = pi..3*pi, evaluated on the first half
+void sse2::trigwin(float* d, int size, const double* p, int order)
+{
 	double temp = 2.0*M_PI/static_cast<double>(size-1);
 	double wre = cos(temp), wim = sin(temp);
-	double re=-1.0, im=0;
+	double re=-1.0, im=0, x;
 	for (int i=0; i<=(size>>1); i++) {
-		d[size-i-1] = d[i] = static_cast<float> (c0+(c1+(c2+c3*re)*re)*re);
+		x = p[order];
+		for (int k=order-1; k>=0; k--) {x = p[k] + x*re;}
+		d[size-i-1] = d[i] = static_cast<float>(x);
 		temp = re; re = wre*re - wim*im; im = wre*im + wim*temp;
 	}
 }
@@ -1111,14 +1270,8 @@ void BlkDsp::bhw4(float* d, int size)
 void BlkDsp::flattop(float* d, int size)
 {
 	if (size == 1) {d[0] = 1.0f; return;}
-	const double c0=-0.0555, c1=0.1651, c2=0.5005, c3=0.3344, c4=0.0555;
-	double temp = 2.0*M_PI/static_cast<double>(size-1);
-	double wre = cos(temp), wim = sin(temp);
-	double re=-1.0, im=0;
-	for (int i=0; i<=(size>>1); i++) {
-		d[size-i-1] = d[i] = static_cast<float>(c0+(c1+(c2+(c3+c4*re)*re)*re)*re);
-		temp = re; re = wre*re - wim*im; im = wre*im + wim*temp;
-	}		
+	const double p[5] = {-0.0555, 0.1651, 0.5005, 0.3344, 0.0555};
+	kernels().trigwin(d, size, p, 4);
 }
 
 // gaussian window, sigma = standard deviation
@@ -1152,7 +1305,8 @@ void BlkDsp::kaiser(float* d, int size,	double alpha)
 //* elementary real array operations
 //*
 // |d| -> d
-void BlkDsp::abs(float* d, int size)
+void BlkDsp::abs(float* d, int size) {kernels().abs(d,size);}
+void sse2::abs(float* d, int size)
 {
 	int i=0;
 #ifndef ICSTLIB_NO_SSEOPT  
@@ -1302,7 +1456,9 @@ void BlkDsp::finv(float* d, int size)
 
 // fast square root
 // full precision, faster than rsqrt-newton version on Core2
-void BlkDsp::fsqrt(float* d, int size)
+void BlkDsp::fsqrt(float* d, int size) {
+	kernels().fsqrt(d,size);}
+void sse2::fsqrt(float* d, int size)
 {
 #ifdef ICSTLIB_NO_SSEOPT  
 	for (int i=0; i<size; i++) {d[i] = sqrtf(d[i]);}
@@ -1485,7 +1641,9 @@ void BlkDsp::fsin(float* d, int size)
 // (optimization note: although the SSE code looks like causing dependency stalls,
 //  the routine is very fast on Core2 and Pentium M CPUs, probably due to efficient
 //  register renaming and out-of-order execution, performance on P4 yet unknown)
-void BlkDsp::logabs(float* d, int size)
+void BlkDsp::logabs(float* d, int size) {
+	kernels().logabs(d,size);}
+void sse2::logabs(float* d, int size)
 {
 	static const float ln2 = logf(2.0f);
 #ifdef ICSTLIB_NO_SSEOPT
@@ -2022,7 +2180,9 @@ float BlkDsp::sum(float* d, int size)
 }			
 
 // return signal energy of d: <d,d>
-float BlkDsp::energy(float* d, int size)
+float BlkDsp::energy(float* d, int size) {
+	return kernels().energy(d,size);}
+float sse2::energy(float* d, int size)
 {
 #ifdef ICSTLIB_NO_SSEOPT  
 	int i, rm = size - ((size>>3)<<3);
@@ -2436,7 +2596,8 @@ void BlkDsp::limit(float* d, int size, float hi, float lo)
 }	
 
 // c*d -> d
-void BlkDsp::mul(float* d, float c, int size)
+void BlkDsp::mul(float* d, float c, int size) {kernels().mulc(d,c,size);}
+void sse2::mulc(float* d, float c, int size)
 {
 	int i=0;
 #ifndef ICSTLIB_NO_SSEOPT  
@@ -2470,7 +2631,8 @@ void BlkDsp::mul(float* d, float c, int size)
 }	
 
 // fill d with element-wise product of d*r
-void BlkDsp::mul(float* d, float* r, int size)
+void BlkDsp::mul(float* d, float* r, int size) {kernels().mul(d,r,size);}
+void sse2::mul(float* d, float* r, int size)
 {
 	int i=0;
 #ifndef ICSTLIB_NO_SSEOPT  
@@ -2506,7 +2668,9 @@ void BlkDsp::mul(float* d, float* r, int size)
 }	
 
 // return dot product: <d,r>
-float BlkDsp::dotp(float* d, float* r, int size)
+float BlkDsp::dotp(float* d, float* r, int size) {
+	return kernels().dotp(d,r,size);}
+float sse2::dotp(float* d, float* r, int size)
 {
 #ifdef ICSTLIB_NO_SSEOPT  
 	int i, rm = size - ((size>>4)<<4); float x=0; double y; 
@@ -2700,7 +2864,9 @@ float BlkDsp::dotp(float* d, float* r, int size)
 }
 
 // return squared distance	
-float BlkDsp::sdist(float* d, float* r, int size)
+float BlkDsp::sdist(float* d, float* r, int size) {
+	return kernels().sdist(d,r,size);}
+float sse2::sdist(float* d, float* r, int size)
 {
 #ifndef ICSTLIB_NO_SSEOPT  
 	if ((reinterpret_cast<uintptr_t>(d) | reinterpret_cast<uintptr_t>(r)) & 0xF) {
@@ -2867,7 +3033,8 @@ void BlkDsp::min(float* d, float* r, int size)
 }
 
 // d+c -> d
-void BlkDsp::add(float* d, float c, int size)
+void BlkDsp::add(float* d, float c, int size) {kernels().addc(d,c,size);}
+void sse2::addc(float* d, float c, int size)
 {
 	int i=0;
 #ifndef ICSTLIB_NO_SSEOPT  
@@ -2901,7 +3068,8 @@ void BlkDsp::add(float* d, float c, int size)
 }	
 
 // d+r -> d
-void BlkDsp::add(float* d, float* r, int size)
+void BlkDsp::add(float* d, float* r, int size) {kernels().add(d,r,size);}
+void sse2::add(float* d, float* r, int size)
 {
 	int i=0;
 #ifndef ICSTLIB_NO_SSEOPT  
@@ -2977,6 +3145,8 @@ void BlkDsp::sub(float* d, float* r, int size)
 
 // multiply-accumulate: d + c*r -> d
 void BlkDsp::mac(float* d, float* r, float c, int size) {
+	kernels().mac(d,r,c,size);}
+void sse2::mac(float* d, float* r, float c, int size) {
 	int i=0;
 #ifndef ICSTLIB_NO_SSEOPT  
 	if ((reinterpret_cast<uintptr_t>(d) | reinterpret_cast<uintptr_t>(r)) & 0xF) {
@@ -3570,6 +3740,38 @@ void BlkDsp::fccorr(float* d, float* r, int dsize, int rsize)
 	realifft(d,tsize);
 }
 
+// fast convolution(d,r) with prepared r -> d
+// input:	d[0..dsize-1], r: spectrum of r[0..rsize-1]
+// output:	d[0..dsize+rsize-2]
+// size of d >= r.GetSize(), dsize <= dsize of r
+void BlkDsp::fconv(float* d, const FftKernel& r, int dsize) {fxcorr(d,r,dsize,false);}
+
+// fast cross correlation(d,r) with prepared r -> d
+// input:	d[0..dsize-1], r: spectrum of r[0..rsize-1]
+// output:	d[0..dsize-1]
+// size of d >= r.GetSize(), dsize <= dsize of r
+void BlkDsp::fccorr(float* d, const FftKernel& r, int dsize) {fxcorr(d,r,dsize,true);}
+
+// multiply by the prepared spectrum (conj = false) or its conjugate (true),
+// if r holds the other one: d*conj(s) = conj(conj(d)*s)
+void BlkDsp::fxcorr(float* d, const FftKernel& r, int dsize, bool conj)
+{
+	int tsize = r.tsize;
+	int hsize = tsize>>1;
+	set(d+dsize, 0, tsize-dsize);
+	realfft(d,tsize);
+	float tmp = d[1]*r.nyq;	// process aligned if d is aligned
+	d[1] = 0;				//
+	if (conj != r.conj) {
+		cpxconj(d,hsize);
+		cpxmul(d,r.spec,hsize);
+		cpxconj(d,hsize);
+	}
+	else {cpxmul(d,r.spec,hsize);}
+	d[1] = tmp;
+	realifft(d,tsize);
+}
+
 // FFT-based fast biased autocorrelation of d
 // d[0..size-1] -> d[0..size-1], size of d => nexthipow2(2*size)
 void BlkDsp::facorr(float* d, int size)
@@ -3805,7 +4007,9 @@ void BlkDsp::cpxinv(float* d, int size, bool fullrange)
 }
 
 // fill d with magnitude of r
-void BlkDsp::cpxmag(float* d, float* r, int size)
+void BlkDsp::cpxmag(float* d, float* r, int size) {
+	kernels().cpxmag(d,r,size);}
+void sse2::cpxmag(float* d, float* r, int size)
 {
 #ifdef ICSTLIB_NO_SSEOPT
 	int i, j=0;
@@ -3817,7 +4021,9 @@ void BlkDsp::cpxmag(float* d, float* r, int size)
 }
 
 // fill d with magnitude^2 of r
-void BlkDsp::cpxpow(float* d, float* r, int size)
+void BlkDsp::cpxpow(float* d, float* r, int size) {
+	kernels().cpxpow(d,r,size);}
+void sse2::cpxpow(float* d, float* r, int size)
 {
 	int i=0, j=0;
 #ifndef ICSTLIB_NO_SSEOPT  
@@ -3993,7 +4199,8 @@ void BlkDsp::cpxsub(float* d, cpx c, int size) {
 void BlkDsp::cpxsub(float* d, float* r, int size) {sub(d,r,2*size);}
 
 // c*d -> d
-void BlkDsp::cpxmul(float* d, cpx c, int size)
+void BlkDsp::cpxmul(float* d, cpx c, int size) {kernels().cpxmulc(d,c,size);}
+void sse2::cpxmulc(float* d, cpx c, int size)
 {		
 	int i=0; float tmp;
 #ifdef ICSTLIB_NO_SSEOPT  
@@ -4050,7 +4257,8 @@ void BlkDsp::cpxmul(float* d, cpx c, int size)
 }
 
 // d*r -> d
-void BlkDsp::cpxmul(float* d, float* r, int size)
+void BlkDsp::cpxmul(float* d, float* r, int size) {kernels().cpxmul(d,r,size);}
+void sse2::cpxmul(float* d, float* r, int size)
 {
 	int i=0; float tmp;
 #ifdef ICSTLIB_NO_SSEOPT  
@@ -4109,7 +4317,9 @@ void BlkDsp::cpxmul(float* d, float* r, int size)
 }
 
 // d + c*r -> d
-void BlkDsp::cpxmac(float* d, float* r, cpx c, int size)
+void BlkDsp::cpxmac(float* d, float* r, cpx c, int size) {
+	kernels().cpxmac(d,r,c,size);}
+void sse2::cpxmac(float* d, float* r, cpx c, int size)
 {
 	int i=0;
 #ifdef ICSTLIB_NO_SSEOPT  
@@ -4167,6 +4377,70 @@ void BlkDsp::cpxmac(float* d, float* r, cpx c, int size)
 #endif	
 }
 
+// d + r*s -> d
+void BlkDsp::cpxmac(float* d, float* r, float* s, int size) {
+	kernels().cpxmacv(d,r,s,size);}
+void sse2::cpxmacv(float* d, float* r, float* s, int size)
+{
+	int i=0;
+#ifdef ICSTLIB_NO_SSEOPT  
+	for (i=0; i<(2*size); i+=2) {
+		d[i] += (r[i]*s[i] - r[i+1]*s[i+1]);
+		d[i+1] += (r[i]*s[i+1] + r[i+1]*s[i]);
+	}
+#else
+	__m128 r0,r1,r2,r3,mask1,mask2;
+	mask1 = _mm_castsi128_ps(_mm_set_epi32(0,0xffffffff,0,0xffffffff));
+	mask2 = _mm_castsi128_ps(_mm_set_epi32(0xffffffff,0,0xffffffff,0));		
+	size <<= 1;
+	if (!((reinterpret_cast<uintptr_t>(d) | reinterpret_cast<uintptr_t>(r) |
+			reinterpret_cast<uintptr_t>(s)) & 0xF)) {
+		while (i <= (size - 4)) {
+			r0 = _mm_load_ps(r+i);
+			r1 = _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(2,3,0,1));
+			r2 = _mm_load_ps(s+i);
+			r0 = _mm_mul_ps(r0 , r2);
+			r1 = _mm_mul_ps(r1 , r2);
+			r2 = _mm_castsi128_ps(_mm_srli_epi64(_mm_castps_si128(r0) , 32));
+			r3 = _mm_castsi128_ps(_mm_slli_epi64(_mm_castps_si128(r1) , 32));
+			r0 = _mm_and_ps(r0 , mask1); 
+			r1 = _mm_and_ps(r1, mask2);			
+			r2 = _mm_sub_ps(r0 , r2);
+			r3 = _mm_add_ps(r1 , r3);
+			r3 = _mm_or_ps(r3 , r2);
+			r2 = _mm_load_ps(d+i);
+			r3 = _mm_add_ps(r3 , r2);
+			_mm_store_ps(d+i , r3);
+			i+=4;
+		}
+	}
+	else {
+		while (i <= (size - 4)) {
+			r0 = _mm_loadu_ps(r+i);
+			r1 = _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(2,3,0,1));
+			r2 = _mm_loadu_ps(s+i);
+			r0 = _mm_mul_ps(r0 , r2);
+			r1 = _mm_mul_ps(r1 , r2);
+			r2 = _mm_castsi128_ps(_mm_srli_epi64(_mm_castps_si128(r0) , 32));
+			r3 = _mm_castsi128_ps(_mm_slli_epi64(_mm_castps_si128(r1) , 32));
+			r0 = _mm_and_ps(r0 , mask1); 
+			r1 = _mm_and_ps(r1, mask2);			
+			r2 = _mm_sub_ps(r0 , r2);
+			r3 = _mm_add_ps(r1 , r3);
+			r3 = _mm_or_ps(r3 , r2);
+			r2 = _mm_loadu_ps(d+i);
+			r3 = _mm_add_ps(r3 , r2);
+			_mm_storeu_ps(d+i , r3);
+			i+=4;
+		}	
+	}
+	if (size & 2) {
+		d[i] += (r[i]*s[i] - r[i+1]*s[i+1]);
+		d[i+1] += (r[i]*s[i+1] + r[i+1]*s[i]);
+	}
+#endif	
+}
+
 // fill d with argument of r
 void BlkDsp::cpxarg(float* d, float* r, int size)
 {
@@ -7342,6 +7616,10 @@ void BlkDsp::ssefree(void* p)
 #endif		
 }
 
+// instruction set of the dispatched kernels
+int BlkDsp::CpuIsa() {return cpuisa();}
+int BlkDsp::LimitCpuIsa(int isa) {return limitcpuisa(isa);}
+
 //******************************************************************************
 //* internal functions
 //*
@@ -7674,5 +7952,30 @@ int CircBuffer::GetWriteSize()
 	return x;
 }
 
+//******************************************************************************
+//* prepared FFT kernel
+//*
+FftKernel::FftKernel(float* r, int rsize, int dsize, bool ccorr)
+{
+	tsize = BlkDsp::nexthipow2(rsize + dsize);
+	ksize = rsize;
+	conj = ccorr;
+	spec = BlkDsp::sseallocf(tsize);
+	memcpy(spec,r,rsize*sizeof(float));
+	BlkDsp::set(spec+rsize, 0, tsize-rsize);
+	BlkDsp::realfft(spec,tsize);
+	nyq = spec[1];
+	spec[1] = 0;
+	if (conj) {BlkDsp::cpxconj(spec,tsize>>1);}
+}
+
+FftKernel::~FftKernel() {BlkDsp::ssefree(spec);}
+
+// transform size
+int FftKernel::GetSize() const {return tsize;}
+
+// kernel size
+int FftKernel::GetKernelSize() const {return ksize;}
+
 }	// end library specific namespace
 
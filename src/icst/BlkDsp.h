@@ -13,6 +13,8 @@
 
 namespace icstdsp {		// begin library specific namespace
 
+class FftKernel;
+
 class BlkDsp
 {
 //******************************* user methods ***********************************
@@ -23,6 +25,9 @@ public:
 // realfft,realifft original domain format: re[0],re[1],..,re[size-1]
 // realfft,realifft transform domain format (contains lower half spectrum): 
 //		re[0],*** re[size/2] ***,re[1],im[1],..,re[size/2-1],im[size/2-1]
+// batched realfft,realifft: frames of the above format, frame k at d[k*stride]
+//		(stride >= size) or in structure of arrays (SoA) layout, sample i of
+//		frame k at d[i*frames+k], several frames run in parallel SIMD lanes
 // realsymfft,realsymifft format (contains lower half): re[0],re[1],..,re[size]
 // dct,idct,dst,idst format: re[0],re[1],..,re[size-1]
 // hwt,ihwt original domain format: [0..size-1]
@@ -36,6 +41,14 @@ static void realfft(float* d, int size);			// FFT of real data
 static void realfft(double* d, int size);
 static void realifft(float* d, int size);			// IFFT to real data
 static void realifft(double* d, int size);
+static void realfft(float* d, int size,				// batched FFT of real data,
+					int frames, int stride);		// frame k at d[k*stride]
+static void realifft(float* d, int size,			// batched IFFT to real data
+					int frames, int stride);		//
+static void realfftsoa(float* d, int size,			// batched FFT of real data,
+						int frames);				// SoA: d[i*frames+k]
+static void realifftsoa(float* d, int size,			// batched IFFT to real data,
+						int frames);				// SoA
 static void realsymfft(float* d, int size);			// FFT of symmetrical real
 static void realsymfft(double* d, int size);		// data
 static void realsymifft(float* d, int size);		// IFFT to symmetrical real
@@ -157,6 +170,11 @@ static void fconv(	float* d, 						// fast convolution(d,r):
 					int dsize, 						// -> d[0..dsize+rsize-2]
 					int rsize	);					// space of both d and r: 
 													// => nexthipow2(dsize+rsize)
+static void fconv(	float* d,						// fast convolution(d,r) with
+					const FftKernel& r,				// prepared r, r unchanged:
+					int dsize	);					// d[0..dsize-1] -> 
+													// d[0..dsize+rsize-2], space
+													// of d => r.GetSize()
 static void ccorr(float* d, float* r, int dsize, 	// cross correlation(d,r) -> d
 					int rsize, int pts);			// d[0..dsize-1],r[0..rsize-1]
 													// -> d[0..pts-1], pts<=dsize
@@ -165,6 +183,10 @@ static void fccorr(	float* d,	 					// fast cross correlation(d,r):
 					int dsize,						// -> d[0..dsize-1]
 					int rsize	);					// space of both d and r: 
 													// => nexthipow2(dsize+rsize)
+static void fccorr(	float* d,						// fast cross correlation(d,r)
+					const FftKernel& r,				// with prepared r, r unchanged:
+					int dsize	);					// d[0..dsize-1] -> d[0..dsize-1]
+													// space of d => r.GetSize()
 static void uacorr(float* d, float* r,				// unbiased autocorrelation of
 					int dsize, int rsize);			// r[0..rsize-1]->d[0..dsize-1] 
 													// dsize <= rsize
@@ -203,6 +225,8 @@ static void cpxmul(float* d, cpx c, int size);		// c*d -> d
 static void cpxmul(float* d, float* r, int size);	// d*r -> d
 static void cpxmac(float* d, float* r, 				// d + c*r -> d
 					cpx c, int size);
+static void cpxmac(float* d, float* r, 				// d + r*s -> d
+					float* s, int size);
 static cpx cpxdotp(float* d, float* r, int size);	// return dot product: <d,r*>
 static void cpxre(float* re, float* d, int size);	// Re(d) -> re	(re=d ok)
 static void cpxim(float* im, float* d, int size);	// Im(d) -> im	(im=d ok)			
@@ -478,10 +502,17 @@ static void PrepareTransforms();					// preallocate resources to speed
 static void UnPrepareTransforms();					// free resources allocated by
 													// PrepareTransforms, call before
 													// the application terminates
+static int CpuIsa();								// instruction set used by the
+													// hot kernels, detected on first
+													// use: 0 SSE2, 1 AVX2, 2 AVX-512
+static int LimitCpuIsa(int isa);					// use at most isa (for tests and
+													// benchmarks), return level in
+													// effect, not during processing
 
 //----------------------------- internal only ------------------------------------
 private:
 static void trigwin2(float* d, int size, double c0, double c1);
+static void fxcorr(float* d, const FftKernel& r, int dsize, bool conj);
 static void trigwin4(float* d, int size, double c0, double c1,
 							double c2, double c3);
 static double bessi0(double x);
@@ -517,6 +548,33 @@ private:
 	CircBuffer(const CircBuffer& src);
 };
 
+//*************************** prepared FFT kernel ********************************
+// spectrum of r for repeated BlkDsp::fconv/fccorr calls with the same r, 
+// computed once: each call costs one forward FFT, one complex multiply and
+// one inverse FFT, same results as fconv/fccorr(d,r,dsize,rsize)
+class FftKernel
+{
+public:
+	FftKernel(float* r, int rsize, int dsize,		// prepare r[0..rsize-1] for
+				bool ccorr=false);					// d of up to dsize elements,
+													// ccorr: for fccorr, else fconv
+													// (the other costs 2 cpxconj)
+	~FftKernel();
+	int GetSize() const;							// transform size, required
+													// space of d
+	int GetKernelSize() const;						// rsize
+private:
+	float* spec;									// spectrum of r, conjugate if
+													// ccorr, Nyquist bin [1] = 0
+	float nyq;										// Nyquist bin
+	int tsize;										// transform size
+	int ksize;										// kernel size
+	bool conj;										// spec is conjugate
+	FftKernel& operator = (const FftKernel& src);
+	FftKernel(const FftKernel& src);
+	friend class BlkDsp;
+};
+
 }	// end library specific namespace
 
 #endif
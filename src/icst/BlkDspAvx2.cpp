@@ -0,0 +1,453 @@
+// BlkDspAvx2.cpp
+// AVX2 + FMA versions of the dispatched kernels, see CpuDispatch.h
+// compile with AVX2 and FMA enabled (gcc/clang: -mavx2 -mfma), without
+// these flags only an empty table is provided
+//
+// This code is part of the ICST DSP Library version 1.2. It is released
+// under the 2-clause BSD license. Copyright (c) 2008-2010, Zurich
+// University of the Arts, Beat Frei. All rights reserved.
+
+#include "Common.h"
+#include "CpuDispatch.h"
+#include "MathDefs.h"
+#if !defined(ICSTLIB_NO_SSEOPT) && defined(__AVX2__) && defined(__FMA__)
+	#include <immintrin.h>	// AVX2, FMA intrinsics
+	#include "FftSoa.h"
+	#define ICSTDSP_AVX2_KERNELS
+#endif
+
+namespace icstdsp {		// begin library specific namespace
+
+#ifdef ICSTDSP_AVX2_KERNELS
+namespace avx2 {
+namespace {								// begin anonymous namespace
+
+// d+c -> d
+void addc(float* d, float c, int size)
+{
+	int i=0;
+	__m256 vc = _mm256_set1_ps(c);
+	for (; i<=(size-16); i+=16) {
+		_mm256_storeu_ps(d+i, _mm256_add_ps(_mm256_loadu_ps(d+i), vc));
+		_mm256_storeu_ps(d+i+8, _mm256_add_ps(_mm256_loadu_ps(d+i+8), vc));
+	}
+	if (i <= (size-8)) {
+		_mm256_storeu_ps(d+i, _mm256_add_ps(_mm256_loadu_ps(d+i), vc));
+		i+=8;
+	}
+	for (; i<size; i++) {d[i] += c;}
+}
+
+// d+r -> d
+void add(float* d, float* r, int size)
+{
+	int i=0;
+	for (; i<=(size-16); i+=16) {
+		_mm256_storeu_ps(d+i, _mm256_add_ps(_mm256_loadu_ps(d+i),
+											_mm256_loadu_ps(r+i)));
+		_mm256_storeu_ps(d+i+8, _mm256_add_ps(_mm256_loadu_ps(d+i+8),
+											  _mm256_loadu_ps(r+i+8)));
+	}
+	if (i <= (size-8)) {
+		_mm256_storeu_ps(d+i, _mm256_add_ps(_mm256_loadu_ps(d+i),
+											_mm256_loadu_ps(r+i)));
+		i+=8;
+	}
+	for (; i<size; i++) {d[i] += r[i];}
+}
+
+// c*d -> d
+void mulc(float* d, float c, int size)
+{
+	int i=0;
+	__m256 vc = _mm256_set1_ps(c);
+	for (; i<=(size-16); i+=16) {
+		_mm256_storeu_ps(d+i, _mm256_mul_ps(_mm256_loadu_ps(d+i), vc));
+		_mm256_storeu_ps(d+i+8, _mm256_mul_ps(_mm256_loadu_ps(d+i+8), vc));
+	}
+	if (i <= (size-8)) {
+		_mm256_storeu_ps(d+i, _mm256_mul_ps(_mm256_loadu_ps(d+i), vc));
+		i+=8;
+	}
+	for (; i<size; i++) {d[i] *= c;}
+}
+
+// d*r -> d
+void mul(float* d, float* r, int size)
+{
+	int i=0;
+	for (; i<=(size-16); i+=16) {
+		_mm256_storeu_ps(d+i, _mm256_mul_ps(_mm256_loadu_ps(d+i),
+											_mm256_loadu_ps(r+i)));
+		_mm256_storeu_ps(d+i+8, _mm256_mul_ps(_mm256_loadu_ps(d+i+8),
+											  _mm256_loadu_ps(r+i+8)));
+	}
+	if (i <= (size-8)) {
+		_mm256_storeu_ps(d+i, _mm256_mul_ps(_mm256_loadu_ps(d+i),
+											_mm256_loadu_ps(r+i)));
+		i+=8;
+	}
+	for (; i<size; i++) {d[i] *= r[i];}
+}
+
+// d + c*r -> d
+void mac(float* d, float* r, float c, int size)
+{
+	int i=0;
+	__m256 vc = _mm256_set1_ps(c);
+	for (; i<=(size-32); i+=32) {
+		_mm256_storeu_ps(d+i, _mm256_fmadd_ps(_mm256_loadu_ps(r+i), vc,
+											  _mm256_loadu_ps(d+i)));
+		_mm256_storeu_ps(d+i+8, _mm256_fmadd_ps(_mm256_loadu_ps(r+i+8), vc,
+												_mm256_loadu_ps(d+i+8)));
+		_mm256_storeu_ps(d+i+16, _mm256_fmadd_ps(_mm256_loadu_ps(r+i+16), vc,
+												 _mm256_loadu_ps(d+i+16)));
+		_mm256_storeu_ps(d+i+24, _mm256_fmadd_ps(_mm256_loadu_ps(r+i+24), vc,
+												 _mm256_loadu_ps(d+i+24)));
+	}
+	for (; i<=(size-8); i+=8) {
+		_mm256_storeu_ps(d+i, _mm256_fmadd_ps(_mm256_loadu_ps(r+i), vc,
+											  _mm256_loadu_ps(d+i)));
+	}
+	for (; i<size; i++) {d[i] += (c*r[i]);}
+}
+
+// <d,r>, partial sums of 32 products are accumulated in double precision
+float dotp(float* d, float* r, int size)
+{
+	int i=0;
+	__m256 a0,a1;
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+	for (; i<=(size-32); i+=32) {
+		a0 = _mm256_mul_ps(_mm256_loadu_ps(d+i), _mm256_loadu_ps(r+i));
+		a1 = _mm256_mul_ps(_mm256_loadu_ps(d+i+8), _mm256_loadu_ps(r+i+8));
+		a0 = _mm256_fmadd_ps(_mm256_loadu_ps(d+i+16), _mm256_loadu_ps(r+i+16), a0);
+		a1 = _mm256_fmadd_ps(_mm256_loadu_ps(d+i+24), _mm256_loadu_ps(r+i+24), a1);
+		a0 = _mm256_add_ps(a0, a1);
+		s0 = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm256_castps256_ps128(a0)));
+		s1 = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm256_extractf128_ps(a0, 1)));
+	}
+	a0 = _mm256_setzero_ps();
+	for (; i<=(size-8); i+=8) {
+		a0 = _mm256_fmadd_ps(_mm256_loadu_ps(d+i), _mm256_loadu_ps(r+i), a0);
+	}
+	s0 = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm256_castps256_ps128(a0)));
+	s1 = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm256_extractf128_ps(a0, 1)));
+	s0 = _mm256_add_pd(s0, s1);
+	__m128d h = _mm_add_pd(_mm256_castpd256_pd128(s0), _mm256_extractf128_pd(s0, 1));
+	double y = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+	for (; i<size; i++) {y += static_cast<double>(d[i]*r[i]);}
+	return static_cast<float>(y);
+}
+
+// squared distance, accumulated in single precision like the SSE2 version
+float sdist(float* d, float* r, int size)
+{
+	int i=0; float y,x;
+	__m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+	__m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps(), x0,x1,x2,x3;
+	for (; i<=(size-32); i+=32) {
+		x0 = _mm256_sub_ps(_mm256_loadu_ps(d+i), _mm256_loadu_ps(r+i));
+		x1 = _mm256_sub_ps(_mm256_loadu_ps(d+i+8), _mm256_loadu_ps(r+i+8));
+		x2 = _mm256_sub_ps(_mm256_loadu_ps(d+i+16), _mm256_loadu_ps(r+i+16));
+		x3 = _mm256_sub_ps(_mm256_loadu_ps(d+i+24), _mm256_loadu_ps(r+i+24));
+		a0 = _mm256_fmadd_ps(x0, x0, a0);
+		a1 = _mm256_fmadd_ps(x1, x1, a1);
+		a2 = _mm256_fmadd_ps(x2, x2, a2);
+		a3 = _mm256_fmadd_ps(x3, x3, a3);
+	}
+	for (; i<=(size-8); i+=8) {
+		x0 = _mm256_sub_ps(_mm256_loadu_ps(d+i), _mm256_loadu_ps(r+i));
+		a0 = _mm256_fmadd_ps(x0, x0, a0);
+	}
+	a0 = _mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3));
+	__m128 h = _mm_add_ps(_mm256_castps256_ps128(a0), _mm256_extractf128_ps(a0, 1));
+	h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+	y = _mm_cvtss_f32(_mm_add_ss(h, _mm_shuffle_ps(h, h, 1)));
+	for (; i<size; i++) {x = d[i] - r[i]; y += (x*x);}
+	return y;
+}
+
+// <d,d>, partial sums of 32 squares are accumulated in double precision
+float energy(float* d, int size)
+{
+	int i=0;
+	__m256 a0,a1,x;
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+	for (; i<=(size-32); i+=32) {
+		x = _mm256_loadu_ps(d+i);		a0 = _mm256_mul_ps(x, x);
+		x = _mm256_loadu_ps(d+i+8);		a1 = _mm256_mul_ps(x, x);
+		x = _mm256_loadu_ps(d+i+16);	a0 = _mm256_fmadd_ps(x, x, a0);
+		x = _mm256_loadu_ps(d+i+24);	a1 = _mm256_fmadd_ps(x, x, a1);
+		a0 = _mm256_add_ps(a0, a1);
+		s0 = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm256_castps256_ps128(a0)));
+		s1 = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm256_extractf128_ps(a0, 1)));
+	}
+	a0 = _mm256_setzero_ps();
+	for (; i<=(size-8); i+=8) {
+		x = _mm256_loadu_ps(d+i);
+		a0 = _mm256_fmadd_ps(x, x, a0);
+	}
+	s0 = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm256_castps256_ps128(a0)));
+	s1 = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm256_extractf128_ps(a0, 1)));
+	s0 = _mm256_add_pd(s0, s1);
+	__m128d h = _mm_add_pd(_mm256_castpd256_pd128(s0), _mm256_extractf128_pd(s0, 1));
+	double y = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+	for (; i<size; i++) {y += static_cast<double>(d[i]*d[i]);}
+	return static_cast<float>(y);
+}
+
+// |d| -> d
+void abs(float* d, int size)
+{
+	int i=0;
+	const __m256 sgn = _mm256_set1_ps(-0.0f);
+	for (; i<=(size-16); i+=16) {
+		_mm256_storeu_ps(d+i, _mm256_andnot_ps(sgn, _mm256_loadu_ps(d+i)));
+		_mm256_storeu_ps(d+i+8, _mm256_andnot_ps(sgn, _mm256_loadu_ps(d+i+8)));
+	}
+	if (i <= (size-8)) {
+		_mm256_storeu_ps(d+i, _mm256_andnot_ps(sgn, _mm256_loadu_ps(d+i)));
+		i+=8;
+	}
+	for (; i<size; i++) {d[i] = fabsf(d[i]);}
+}
+
+// sqrt(d) -> d
+void fsqrt(float* d, int size)
+{
+	int i=0;
+	for (; i<=(size-16); i+=16) {
+		_mm256_storeu_ps(d+i, _mm256_sqrt_ps(_mm256_loadu_ps(d+i)));
+		_mm256_storeu_ps(d+i+8, _mm256_sqrt_ps(_mm256_loadu_ps(d+i+8)));
+	}
+	if (i <= (size-8)) {
+		_mm256_storeu_ps(d+i, _mm256_sqrt_ps(_mm256_loadu_ps(d+i)));
+		i+=8;
+	}
+	for (; i<size; i++) {d[i] = sqrtf(d[i]);}
+}
+
+// ln|d| -> d, same approximation as the SSE2 version, the last partial
+// register is processed with masked loads and stores
+void logabs(float* d, int size)
+{
+	static const float ln2 = logf(2.0f);
+	const __m256i msk1 = _mm256_set1_epi32(0x007fffff);
+	const __m256i msk2 = _mm256_set1_epi32(0x3f800000);
+	const __m256i msk3 = _mm256_set1_epi32(0x7f800000);
+	const __m256i idx = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+	const __m256 c1 = _mm256_set1_ps(1.0f);
+	const __m256 c2 = _mm256_set1_ps(1.0f + 127.0f/256.0f);
+	const __m256 c3 = _mm256_set1_ps(256.0f*ln2);
+	__m256i x,m;
+	__m256 p,e,y;
+	for (int i=0; i<size; i+=8) {
+		m = _mm256_cmpgt_epi32(_mm256_set1_epi32(size-i), idx);
+		x = _mm256_castps_si256(_mm256_maskload_ps(d+i, m));
+		p = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(
+				_mm256_and_si256(x, msk1), msk2)), c1);
+		e = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(
+				_mm256_srli_epi32(_mm256_and_si256(x, msk3), 8), msk2)), c2);
+		y = _mm256_fmadd_ps(_mm256_set1_ps(0.010253873f), p, _mm256_set1_ps(-0.053340996f));
+		y = _mm256_fmadd_ps(y, p, _mm256_set1_ps(0.132157178f));
+		y = _mm256_fmadd_ps(y, p, _mm256_set1_ps(-0.224147341f));
+		y = _mm256_fmadd_ps(y, p, _mm256_set1_ps(0.327615235f));
+		y = _mm256_fmadd_ps(y, p, _mm256_set1_ps(-0.499365619f));
+		y = _mm256_fmadd_ps(y, p, _mm256_set1_ps(0.999974853f));
+		y = _mm256_fmadd_ps(y, p, _mm256_mul_ps(e, c3));
+		_mm256_maskstore_ps(d+i, m, y);
+	}
+}
+
+// c*d -> d, complex: re(a*b) = a.re*b.re - a.im*b.im (even lanes of
+// fmaddsub), im(a*b) = a.im*b.re + a.re*b.im (odd lanes)
+void cpxmulc(float* d, cpx c, int size)
+{
+	int i=0; float tmp;
+	const __m256 cre = _mm256_set1_ps(c.re), cim = _mm256_set1_ps(c.im);
+	__m256 a;
+	size <<= 1;
+	for (; i<=(size-8); i+=8) {
+		a = _mm256_loadu_ps(d+i);
+		_mm256_storeu_ps(d+i, _mm256_fmaddsub_ps(a, cre,
+						 _mm256_mul_ps(_mm256_permute_ps(a, 0xB1), cim)));
+	}
+	for (; i<size; i+=2) {
+		tmp = d[i];
+		d[i] = tmp*c.re - d[i+1]*c.im;
+		d[i+1] = d[i+1]*c.re + tmp*c.im;
+	}
+}
+
+// d*r -> d, complex
+void cpxmul(float* d, float* r, int size)
+{
+	int i=0; float tmp;
+	__m256 a,b;
+	size <<= 1;
+	for (; i<=(size-8); i+=8) {
+		a = _mm256_loadu_ps(d+i);
+		b = _mm256_loadu_ps(r+i);
+		_mm256_storeu_ps(d+i, _mm256_fmaddsub_ps(a, _mm256_moveldup_ps(b),
+			_mm256_mul_ps(_mm256_permute_ps(a, 0xB1), _mm256_movehdup_ps(b))));
+	}
+	for (; i<size; i+=2) {
+		tmp = d[i];
+		d[i] = tmp*r[i] - d[i+1]*r[i+1];
+		d[i+1] = r[i]*d[i+1] + tmp*r[i+1];
+	}
+}
+
+// d + c*r -> d, complex
+void cpxmac(float* d, float* r, cpx c, int size)
+{
+	int i=0;
+	const __m256 cre = _mm256_set1_ps(c.re), cim = _mm256_set1_ps(c.im);
+	__m256 a;
+	size <<= 1;
+	for (; i<=(size-8); i+=8) {
+		a = _mm256_loadu_ps(r+i);
+		_mm256_storeu_ps(d+i, _mm256_add_ps(_mm256_loadu_ps(d+i),
+			_mm256_fmaddsub_ps(a, cre, _mm256_mul_ps(_mm256_permute_ps(a, 0xB1), cim))));
+	}
+	for (; i<size; i+=2) {
+		d[i] += (r[i]*c.re - r[i+1]*c.im);
+		d[i+1] += (r[i]*c.im + r[i+1]*c.re);
+	}
+}
+
+// d + r*s -> d, complex
+void cpxmacv(float* d, float* r, float* s, int size)
+{
+	int i=0;
+	__m256 a,b;
+	size <<= 1;
+	for (; i<=(size-8); i+=8) {
+		a = _mm256_loadu_ps(r+i);
+		b = _mm256_loadu_ps(s+i);
+		_mm256_storeu_ps(d+i, _mm256_add_ps(_mm256_loadu_ps(d+i),
+			_mm256_fmaddsub_ps(a, _mm256_moveldup_ps(b),
+			_mm256_mul_ps(_mm256_permute_ps(a, 0xB1), _mm256_movehdup_ps(b)))));
+	}
+	for (; i<size; i+=2) {
+		d[i] += (r[i]*s[i] - r[i+1]*s[i+1]);
+		d[i+1] += (r[i]*s[i+1] + r[i+1]*s[i]);
+	}
+}
+
+// |r|^2 -> d, 8 values from 16 interleaved: hadd pairs the squares within
+// 128 bit halves, permute4x64 restores the order (r=d ok)
+inline __m256 cpxpow8(float* r)
+{
+	__m256 a = _mm256_loadu_ps(r), b = _mm256_loadu_ps(r+8);
+	a = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+	return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(a), 0xD8));
+}
+
+void cpxpow(float* d, float* r, int size)
+{
+	int i=0;
+	for (; i<=(size-8); i+=8) {_mm256_storeu_ps(d+i, cpxpow8(r+2*i));}
+	for (; i<size; i++) {d[i] = r[2*i]*r[2*i] + r[2*i+1]*r[2*i+1];}
+}
+
+// |r| -> d (r=d ok)
+void cpxmag(float* d, float* r, int size)
+{
+	int i=0;
+	for (; i<=(size-8); i+=8) {_mm256_storeu_ps(d+i, _mm256_sqrt_ps(cpxpow8(r+2*i)));}
+	for (; i<size; i++) {d[i] = sqrtf(r[2*i]*r[2*i] + r[2*i+1]*r[2*i+1]);}
+}
+
+// trigonometric window, 4 points per step, each lane rotates by 4 points
+void trigwin(float* d, int size, const double* p, int order)
+{
+	int i, k, n = (size>>1) + 1;
+	double phi = 2.0*M_PI/static_cast<double>(size-1);
+	float tmp[4];
+	__m256d re = _mm256_setr_pd(-1.0, -cos(phi), -cos(2.0*phi), -cos(3.0*phi));
+	__m256d im = _mm256_setr_pd(0, -sin(phi), -sin(2.0*phi), -sin(3.0*phi));
+	__m256d wre = _mm256_set1_pd(cos(4.0*phi)), wim = _mm256_set1_pd(sin(4.0*phi));
+	__m256d x,t;
+	__m128 y;
+	for (i=0; i<n; i+=4) {
+		x = _mm256_set1_pd(p[order]);
+		for (k=order-1; k>=0; k--) {x = _mm256_fmadd_pd(x, re, _mm256_set1_pd(p[k]));}
+		y = _mm256_cvtpd_ps(x);
+		if (i <= (n-4)) {_mm_storeu_ps(d+i, y);}
+		else {_mm_storeu_ps(tmp, y); for (k=0; k<(n-i); k++) {d[i+k] = tmp[k];}}
+		t = re;
+		re = _mm256_fmsub_pd(wre, re, _mm256_mul_pd(wim, im));
+		im = _mm256_fmadd_pd(wre, im, _mm256_mul_pd(wim, t));
+	}
+	for (i=0; i<n; i++) {d[size-1-i] = d[i];}
+}
+
+// vector class for the batched real FFT, s. FftSoa.h
+struct SoaAvx2
+{
+	typedef __m256 T;
+	enum {W = 8};
+	static T load(const float* p) {return _mm256_loadu_ps(p);}
+	static void store(float* p, T x) {_mm256_storeu_ps(p, x);}
+	static T set1(float c) {return _mm256_set1_ps(c);}
+	static T add(T a, T b) {return _mm256_add_ps(a, b);}
+	static T sub(T a, T b) {return _mm256_sub_ps(a, b);}
+	static T mul(T a, T b) {return _mm256_mul_ps(a, b);}
+	static T madd(T a, T b, T c) {return _mm256_fmadd_ps(a, b, c);}
+	static T msub(T a, T b, T c) {return _mm256_fmsub_ps(a, b, c);}
+};
+
+// batched real FFT, frames in SoA layout
+void rfftsoa(float* d, int m, int f, const float* tw, int dir) {
+	soarfft<SoaAvx2>(d, m, f, tw, dir);}
+
+// multi-channel envelope follower, 8 lanes per register, rest SSE2
+void envelope(float* d, float* r, float* c, int size, int lanes,
+				int stride, float* atime, float* rtime, int type)
+{
+	int i,l=0;
+	float adn = (type >= 2) ? ANTI_DENORMAL_FLOAT*ANTI_DENORMAL_FLOAT : ANTI_DENORMAL_FLOAT;
+	const __m256 vsgn = _mm256_set1_ps(-0.0f);
+	const __m256 vadn = _mm256_set1_ps(adn);
+	for (; l+8 <= lanes; l+=8) {
+		float ta[8], tr[8];
+		for (i=0; i<8; i++) {							// 1-exp(-1/time) approx.
+			ta[i] = 1.0f/__max(1.0f,atime[l+i]);
+			tr[i] = 1.0f/__max(1.0f,rtime[l+i]);
+		}
+		__m256 va = _mm256_loadu_ps(ta), vr = _mm256_loadu_ps(tr);
+		__m256 vc = _mm256_loadu_ps(c+l), vx, vk;
+		for (i=0; i<size; i++) {
+			vx = _mm256_loadu_ps(d+i*stride+l);
+			if (type == 0) {vx = _mm256_andnot_ps(vsgn,vx);}
+			else {vx = _mm256_mul_ps(vx,vx);}
+			vx = _mm256_add_ps(vx,vadn);
+			vk = _mm256_blendv_ps(vr,va,_mm256_cmp_ps(vx,vc,_CMP_GT_OQ));
+			vc = _mm256_fmadd_ps(vk,_mm256_sub_ps(vx,vc),vc);
+			if (type >= 2) {_mm256_storeu_ps(r+i*stride+l,_mm256_sqrt_ps(vc));}
+			else {_mm256_storeu_ps(r+i*stride+l,vc);}
+		}
+		_mm256_storeu_ps(c+l,vc);
+	}
+	if (l < lanes) {
+		sse2::envelope(d+l, r+l, c+l, size, lanes-l, stride, atime+l, rtime+l, type);
+	}
+}
+
+const KernelTable avx2table = {
+	addc, add, mulc, mul, mac, dotp, sdist, energy, abs, fsqrt, logabs,
+	cpxmulc, cpxmul, cpxmac, cpxmacv, cpxpow, cpxmag, trigwin,
+	rfftsoa, envelope
+};
+
+}										// end anonymous namespace
+
+const KernelTable* const table = &avx2table;
+}
+#else
+const KernelTable* const avx2::table = NULL;
+#endif
+
+}	// end library specific namespace
@@ -0,0 +1,450 @@
+// BlkDspAvx512.cpp
+// AVX-512F versions of the dispatched kernels, see CpuDispatch.h
+// compile with AVX-512F, AVX2 and FMA enabled (gcc/clang: -mavx512f -mavx2
+// -mfma), without these flags only an empty table is provided
+//
+// This code is part of the ICST DSP Library version 1.2. It is released
+// under the 2-clause BSD license. Copyright (c) 2008-2010, Zurich
+// University of the Arts, Beat Frei. All rights reserved.
+
+#include "Common.h"
+#include "CpuDispatch.h"
+#include "MathDefs.h"
+#if !defined(ICSTLIB_NO_SSEOPT) && defined(__AVX512F__) && defined(__FMA__)
+	#include <immintrin.h>	// AVX-512F intrinsics
+	#include "FftSoa.h"
+	#define ICSTDSP_AVX512_KERNELS
+#endif
+
+namespace icstdsp {		// begin library specific namespace
+
+#ifdef ICSTDSP_AVX512_KERNELS
+namespace avx512 {
+namespace {								// begin anonymous namespace
+
+// mask of the first n <= 16 lanes
+inline __mmask16 tailmask(int n) {return static_cast<__mmask16>((1u << n) - 1);}
+
+// d+c -> d
+void addc(float* d, float c, int size)
+{
+	int i=0;
+	__m512 vc = _mm512_set1_ps(c);
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_ps(d+i, _mm512_add_ps(_mm512_loadu_ps(d+i), vc));
+	}
+	if (i < size) {
+		__mmask16 m = tailmask(size-i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_add_ps(_mm512_maskz_loadu_ps(m, d+i), vc));
+	}
+}
+
+// d+r -> d
+void add(float* d, float* r, int size)
+{
+	int i=0;
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_ps(d+i, _mm512_add_ps(_mm512_loadu_ps(d+i),
+											_mm512_loadu_ps(r+i)));
+	}
+	if (i < size) {
+		__mmask16 m = tailmask(size-i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_add_ps(_mm512_maskz_loadu_ps(m, d+i),
+													_mm512_maskz_loadu_ps(m, r+i)));
+	}
+}
+
+// c*d -> d
+void mulc(float* d, float c, int size)
+{
+	int i=0;
+	__m512 vc = _mm512_set1_ps(c);
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_ps(d+i, _mm512_mul_ps(_mm512_loadu_ps(d+i), vc));
+	}
+	if (i < size) {
+		__mmask16 m = tailmask(size-i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, d+i), vc));
+	}
+}
+
+// d*r -> d
+void mul(float* d, float* r, int size)
+{
+	int i=0;
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_ps(d+i, _mm512_mul_ps(_mm512_loadu_ps(d+i),
+											_mm512_loadu_ps(r+i)));
+	}
+	if (i < size) {
+		__mmask16 m = tailmask(size-i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, d+i),
+													_mm512_maskz_loadu_ps(m, r+i)));
+	}
+}
+
+// d + c*r -> d
+void mac(float* d, float* r, float c, int size)
+{
+	int i=0;
+	__m512 vc = _mm512_set1_ps(c);
+	for (; i<=(size-32); i+=32) {
+		_mm512_storeu_ps(d+i, _mm512_fmadd_ps(_mm512_loadu_ps(r+i), vc,
+											  _mm512_loadu_ps(d+i)));
+		_mm512_storeu_ps(d+i+16, _mm512_fmadd_ps(_mm512_loadu_ps(r+i+16), vc,
+												 _mm512_loadu_ps(d+i+16)));
+	}
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_ps(d+i, _mm512_fmadd_ps(_mm512_loadu_ps(r+i), vc,
+											  _mm512_loadu_ps(d+i)));
+	}
+	if (i < size) {
+		__mmask16 m = tailmask(size-i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, r+i),
+								vc, _mm512_maskz_loadu_ps(m, d+i)));
+	}
+}
+
+// float to double, low and high 8 lanes
+inline __m512d lo8(__m512 x) {return _mm512_cvtps_pd(_mm512_castps512_ps256(x));}
+inline __m512d hi8(__m512 x)
+{
+	return _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(x), 1)));
+}
+
+// <d,r>, partial sums of 32 products are accumulated in double precision
+float dotp(float* d, float* r, int size)
+{
+	int i=0;
+	__m512 a0,a1;
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+	for (; i<=(size-32); i+=32) {
+		a0 = _mm512_mul_ps(_mm512_loadu_ps(d+i), _mm512_loadu_ps(r+i));
+		a1 = _mm512_mul_ps(_mm512_loadu_ps(d+i+16), _mm512_loadu_ps(r+i+16));
+		a0 = _mm512_add_ps(a0, a1);
+		s0 = _mm512_add_pd(s0, lo8(a0));
+		s1 = _mm512_add_pd(s1, hi8(a0));
+	}
+	if (i < size) {
+		a0 = _mm512_setzero_ps();
+		for (; i<=(size-16); i+=16) {
+			a0 = _mm512_fmadd_ps(_mm512_loadu_ps(d+i), _mm512_loadu_ps(r+i), a0);
+		}
+		if (i < size) {
+			__mmask16 m = tailmask(size-i);
+			a0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, d+i),
+								 _mm512_maskz_loadu_ps(m, r+i), a0);
+		}
+		s0 = _mm512_add_pd(s0, lo8(a0));
+		s1 = _mm512_add_pd(s1, hi8(a0));
+	}
+	return static_cast<float>(_mm512_reduce_add_pd(_mm512_add_pd(s0, s1)));
+}
+
+// squared distance, accumulated in single precision like the SSE2 version
+float sdist(float* d, float* r, int size)
+{
+	int i=0;
+	__m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps(), x0,x1;
+	for (; i<=(size-32); i+=32) {
+		x0 = _mm512_sub_ps(_mm512_loadu_ps(d+i), _mm512_loadu_ps(r+i));
+		x1 = _mm512_sub_ps(_mm512_loadu_ps(d+i+16), _mm512_loadu_ps(r+i+16));
+		a0 = _mm512_fmadd_ps(x0, x0, a0);
+		a1 = _mm512_fmadd_ps(x1, x1, a1);
+	}
+	for (; i<size; i+=16) {
+		__mmask16 m = tailmask(__min(size-i,16));
+		x0 = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, d+i), _mm512_maskz_loadu_ps(m, r+i));
+		a0 = _mm512_fmadd_ps(x0, x0, a0);
+	}
+	return _mm512_reduce_add_ps(_mm512_add_ps(a0, a1));
+}
+
+// <d,d>, partial sums of 32 squares are accumulated in double precision
+float energy(float* d, int size)
+{
+	int i=0;
+	__m512 a0,a1,x;
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+	for (; i<=(size-32); i+=32) {
+		x = _mm512_loadu_ps(d+i);		a0 = _mm512_mul_ps(x, x);
+		x = _mm512_loadu_ps(d+i+16);	a1 = _mm512_mul_ps(x, x);
+		a0 = _mm512_add_ps(a0, a1);
+		s0 = _mm512_add_pd(s0, lo8(a0));
+		s1 = _mm512_add_pd(s1, hi8(a0));
+	}
+	if (i < size) {
+		a0 = _mm512_setzero_ps();
+		for (; i<size; i+=16) {
+			x = _mm512_maskz_loadu_ps(tailmask(__min(size-i,16)), d+i);
+			a0 = _mm512_fmadd_ps(x, x, a0);
+		}
+		s0 = _mm512_add_pd(s0, lo8(a0));
+		s1 = _mm512_add_pd(s1, hi8(a0));
+	}
+	return static_cast<float>(_mm512_reduce_add_pd(_mm512_add_pd(s0, s1)));
+}
+
+// |d| -> d
+void abs(float* d, int size)
+{
+	int i=0;
+	const __m512i msk = _mm512_set1_epi32(0x7fffffff);
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_si512(d+i, _mm512_and_epi32(msk,
+							_mm512_loadu_si512(d+i)));
+	}
+	if (i < size) {
+		__mmask16 m = tailmask(size-i);
+		_mm512_mask_storeu_epi32(d+i, m, _mm512_and_epi32(msk,
+								 _mm512_maskz_loadu_epi32(m, d+i)));
+	}
+}
+
+// sqrt(d) -> d
+void fsqrt(float* d, int size)
+{
+	int i=0;
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_ps(d+i, _mm512_sqrt_ps(_mm512_loadu_ps(d+i)));
+	}
+	if (i < size) {
+		__mmask16 m = tailmask(size-i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_sqrt_ps(_mm512_maskz_loadu_ps(m, d+i)));
+	}
+}
+
+// ln|d| -> d, same approximation as the SSE2 version
+void logabs(float* d, int size)
+{
+	static const float ln2 = logf(2.0f);
+	const __m512i msk1 = _mm512_set1_epi32(0x007fffff);
+	const __m512i msk2 = _mm512_set1_epi32(0x3f800000);
+	const __m512i msk3 = _mm512_set1_epi32(0x7f800000);
+	const __m512 c1 = _mm512_set1_ps(1.0f);
+	const __m512 c2 = _mm512_set1_ps(1.0f + 127.0f/256.0f);
+	const __m512 c3 = _mm512_set1_ps(256.0f*ln2);
+	__m512i x;
+	__m512 p,e,y;
+	__mmask16 m;
+	for (int i=0; i<size; i+=16) {
+		m = tailmask(__min(size-i,16));
+		x = _mm512_maskz_loadu_epi32(m, d+i);
+		p = _mm512_sub_ps(_mm512_castsi512_ps(_mm512_or_epi32(
+				_mm512_and_epi32(x, msk1), msk2)), c1);
+		e = _mm512_sub_ps(_mm512_castsi512_ps(_mm512_or_epi32(
+				_mm512_srli_epi32(_mm512_and_epi32(x, msk3), 8), msk2)), c2);
+		y = _mm512_fmadd_ps(_mm512_set1_ps(0.010253873f), p, _mm512_set1_ps(-0.053340996f));
+		y = _mm512_fmadd_ps(y, p, _mm512_set1_ps(0.132157178f));
+		y = _mm512_fmadd_ps(y, p, _mm512_set1_ps(-0.224147341f));
+		y = _mm512_fmadd_ps(y, p, _mm512_set1_ps(0.327615235f));
+		y = _mm512_fmadd_ps(y, p, _mm512_set1_ps(-0.499365619f));
+		y = _mm512_fmadd_ps(y, p, _mm512_set1_ps(0.999974853f));
+		y = _mm512_fmadd_ps(y, p, _mm512_mul_ps(e, c3));
+		_mm512_mask_storeu_ps(d+i, m, y);
+	}
+}
+
+// c*d -> d, complex: re(a*b) = a.re*b.re - a.im*b.im (even lanes of
+// fmaddsub), im(a*b) = a.im*b.re + a.re*b.im (odd lanes)
+void cpxmulc(float* d, cpx c, int size)
+{
+	int i=0;
+	const __m512 cre = _mm512_set1_ps(c.re), cim = _mm512_set1_ps(c.im);
+	__m512 a;
+	__mmask16 m;
+	size <<= 1;
+	for (; i<size; i+=16) {
+		m = (i <= (size-16)) ? static_cast<__mmask16>(0xffff) : tailmask(size-i);
+		a = _mm512_maskz_loadu_ps(m, d+i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_fmaddsub_ps(a, cre,
+							  _mm512_mul_ps(_mm512_permute_ps(a, 0xB1), cim)));
+	}
+}
+
+// d*r -> d, complex
+void cpxmul(float* d, float* r, int size)
+{
+	int i=0;
+	__m512 a,b;
+	__mmask16 m;
+	size <<= 1;
+	for (; i<size; i+=16) {
+		m = (i <= (size-16)) ? static_cast<__mmask16>(0xffff) : tailmask(size-i);
+		a = _mm512_maskz_loadu_ps(m, d+i);
+		b = _mm512_maskz_loadu_ps(m, r+i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_fmaddsub_ps(a, _mm512_moveldup_ps(b),
+			_mm512_mul_ps(_mm512_permute_ps(a, 0xB1), _mm512_movehdup_ps(b))));
+	}
+}
+
+// d + c*r -> d, complex
+void cpxmac(float* d, float* r, cpx c, int size)
+{
+	int i=0;
+	const __m512 cre = _mm512_set1_ps(c.re), cim = _mm512_set1_ps(c.im);
+	__m512 a;
+	__mmask16 m;
+	size <<= 1;
+	for (; i<size; i+=16) {
+		m = tailmask(__min(size-i,16));
+		a = _mm512_maskz_loadu_ps(m, r+i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_add_ps(_mm512_maskz_loadu_ps(m, d+i),
+			_mm512_fmaddsub_ps(a, cre, _mm512_mul_ps(_mm512_permute_ps(a, 0xB1), cim))));
+	}
+}
+
+// d + r*s -> d, complex
+void cpxmacv(float* d, float* r, float* s, int size)
+{
+	int i=0;
+	__m512 a,b;
+	__mmask16 m;
+	size <<= 1;
+	for (; i<size; i+=16) {
+		m = (i <= (size-16)) ? static_cast<__mmask16>(0xffff) : tailmask(size-i);
+		a = _mm512_maskz_loadu_ps(m, r+i);
+		b = _mm512_maskz_loadu_ps(m, s+i);
+		_mm512_mask_storeu_ps(d+i, m, _mm512_add_ps(_mm512_maskz_loadu_ps(m, d+i),
+			_mm512_fmaddsub_ps(a, _mm512_moveldup_ps(b),
+			_mm512_mul_ps(_mm512_permute_ps(a, 0xB1), _mm512_movehdup_ps(b)))));
+	}
+}
+
+// |r|^2 of 16 values from 32 interleaved a,b: shuffle pairs the squares
+// within 128 bit lanes, permutexvar restores the order
+inline __m512 cpxpow16(__m512 a, __m512 b)
+{
+	const __m512i idx = _mm512_setr_epi64(0,2,4,6,1,3,5,7);
+	a = _mm512_mul_ps(a, a);
+	b = _mm512_mul_ps(b, b);
+	a = _mm512_add_ps(_mm512_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)),
+					  _mm512_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+	return _mm512_castpd_ps(_mm512_permutexvar_pd(idx, _mm512_castps_pd(a)));
+}
+
+// as above, for the first n < 16 values
+inline __m512 cpxpow16(float* r, int n)
+{
+	return cpxpow16(_mm512_maskz_loadu_ps(tailmask(__min(2*n,16)), r),
+					_mm512_maskz_loadu_ps(tailmask(__max(2*n-16,0)), r+16));
+}
+
+// |r|^2 -> d (r=d ok)
+void cpxpow(float* d, float* r, int size)
+{
+	int i=0;
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_ps(d+i, cpxpow16(_mm512_loadu_ps(r+2*i), _mm512_loadu_ps(r+2*i+16)));
+	}
+	if (i < size) {
+		_mm512_mask_storeu_ps(d+i, tailmask(size-i), cpxpow16(r+2*i, size-i));
+	}
+}
+
+// |r| -> d (r=d ok)
+void cpxmag(float* d, float* r, int size)
+{
+	int i=0;
+	for (; i<=(size-16); i+=16) {
+		_mm512_storeu_ps(d+i, _mm512_sqrt_ps(cpxpow16(_mm512_loadu_ps(r+2*i),
+												   _mm512_loadu_ps(r+2*i+16))));
+	}
+	if (i < size) {
+		_mm512_mask_storeu_ps(d+i, tailmask(size-i), _mm512_sqrt_ps(cpxpow16(r+2*i, size-i)));
+	}
+}
+
+// trigonometric window, 8 points per step, each lane rotates by 8 points
+void trigwin(float* d, int size, const double* p, int order)
+{
+	int i, k, n = (size>>1) + 1;
+	double phi = 2.0*M_PI/static_cast<double>(size-1);
+	__m512d re = _mm512_setr_pd(-1.0, -cos(phi), -cos(2.0*phi), -cos(3.0*phi),
+						-cos(4.0*phi), -cos(5.0*phi), -cos(6.0*phi), -cos(7.0*phi));
+	__m512d im = _mm512_setr_pd(0, -sin(phi), -sin(2.0*phi), -sin(3.0*phi),
+						-sin(4.0*phi), -sin(5.0*phi), -sin(6.0*phi), -sin(7.0*phi));
+	__m512d wre = _mm512_set1_pd(cos(8.0*phi)), wim = _mm512_set1_pd(sin(8.0*phi));
+	__m512d x,t;
+	for (i=0; i<n; i+=8) {
+		x = _mm512_set1_pd(p[order]);
+		for (k=order-1; k>=0; k--) {x = _mm512_fmadd_pd(x, re, _mm512_set1_pd(p[k]));}
+		_mm512_mask_storeu_ps(d+i, tailmask(__min(n-i,8)),
+							  _mm512_castps256_ps512(_mm512_cvtpd_ps(x)));
+		t = re;
+		re = _mm512_fmsub_pd(wre, re, _mm512_mul_pd(wim, im));
+		im = _mm512_fmadd_pd(wre, im, _mm512_mul_pd(wim, t));
+	}
+	for (i=0; i<n; i++) {d[size-1-i] = d[i];}
+}
+
+// vector class for the batched real FFT, s. FftSoa.h
+struct SoaAvx512
+{
+	typedef __m512 T;
+	enum {W = 16};
+	static T load(const float* p) {return _mm512_loadu_ps(p);}
+	static void store(float* p, T x) {_mm512_storeu_ps(p, x);}
+	static T set1(float c) {return _mm512_set1_ps(c);}
+	static T add(T a, T b) {return _mm512_add_ps(a, b);}
+	static T sub(T a, T b) {return _mm512_sub_ps(a, b);}
+	static T mul(T a, T b) {return _mm512_mul_ps(a, b);}
+	static T madd(T a, T b, T c) {return _mm512_fmadd_ps(a, b, c);}
+	static T msub(T a, T b, T c) {return _mm512_fmsub_ps(a, b, c);}
+};
+
+// batched real FFT, frames in SoA layout
+void rfftsoa(float* d, int m, int f, const float* tw, int dir) {
+	soarfft<SoaAvx512>(d, m, f, tw, dir);}
+
+// multi-channel envelope follower, 16 lanes per register, rest AVX2/SSE2
+void envelope(float* d, float* r, float* c, int size, int lanes,
+				int stride, float* atime, float* rtime, int type)
+{
+	int i,l=0;
+	float adn = (type >= 2) ? ANTI_DENORMAL_FLOAT*ANTI_DENORMAL_FLOAT : ANTI_DENORMAL_FLOAT;
+	const __m512i vmsk = _mm512_set1_epi32(0x7fffffff);
+	const __m512 vadn = _mm512_set1_ps(adn);
+	for (; l+16 <= lanes; l+=16) {
+		float ta[16], tr[16];
+		for (i=0; i<16; i++) {							// 1-exp(-1/time) approx.
+			ta[i] = 1.0f/__max(1.0f,atime[l+i]);
+			tr[i] = 1.0f/__max(1.0f,rtime[l+i]);
+		}
+		__m512 va = _mm512_loadu_ps(ta), vr = _mm512_loadu_ps(tr);
+		__m512 vc = _mm512_loadu_ps(c+l), vx, vk;
+		for (i=0; i<size; i++) {
+			vx = _mm512_loadu_ps(d+i*stride+l);
+			if (type == 0) {
+				vx = _mm512_castsi512_ps(_mm512_and_epi32(vmsk, _mm512_castps_si512(vx)));
+			}
+			else {vx = _mm512_mul_ps(vx,vx);}
+			vx = _mm512_add_ps(vx,vadn);
+			vk = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(vx,vc,_CMP_GT_OQ),vr,va);
+			vc = _mm512_fmadd_ps(vk,_mm512_sub_ps(vx,vc),vc);
+			if (type >= 2) {_mm512_storeu_ps(r+i*stride+l,_mm512_sqrt_ps(vc));}
+			else {_mm512_storeu_ps(r+i*stride+l,vc);}
+		}
+		_mm512_storeu_ps(c+l,vc);
+	}
+	if (l < lanes) {
+		const KernelTable* k = (avx2::table != NULL) ? avx2::table : sse2::table;
+		k->envelope(d+l, r+l, c+l, size, lanes-l, stride, atime+l, rtime+l, type);
+	}
+}
+
+const KernelTable avx512table = {
+	addc, add, mulc, mul, mac, dotp, sdist, energy, abs, fsqrt, logabs,
+	cpxmulc, cpxmul, cpxmac, cpxmacv, cpxpow, cpxmag, trigwin,
+	rfftsoa, envelope
+};
+
+}										// end anonymous namespace
+
+const KernelTable* const table = &avx512table;
+}
+#else
+const KernelTable* const avx512::table = NULL;
+#endif
+
+}	// end library specific namespace
@@ -0,0 +1,112 @@
+// CpuDispatch.cpp
+//
+// This code is part of the ICST DSP Library version 1.2. It is released
+// under the 2-clause BSD license. Copyright (c) 2008-2010, Zurich
+// University of the Arts, Beat Frei. All rights reserved.
+
+#include "Common.h"
+#include "CpuDispatch.h"
+#include "MathDefs.h"
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_MSC_VER) && !defined(ICSTLIB_NO_SSEOPT)
+	#include <intrin.h>
+#endif
+
+namespace icstdsp {		// begin library specific namespace
+
+const KernelTable sse2table = {
+	sse2::addc, sse2::add, sse2::mulc, sse2::mul, sse2::mac, sse2::dotp,
+	sse2::sdist, sse2::energy, sse2::abs, sse2::fsqrt, sse2::logabs,
+	sse2::cpxmulc, sse2::cpxmul, sse2::cpxmac, sse2::cpxmacv, sse2::cpxpow,
+	sse2::cpxmag, sse2::trigwin, sse2::rfftsoa, sse2::envelope
+};
+const KernelTable* const sse2::table = &sse2table;
+
+namespace {								// begin anonymous namespace
+	std::atomic<const KernelTable*> active(NULL);
+	std::atomic<int> activeisa(ISA_SSE2);
+	std::atomic<int> isalimit(ISA_AVX512);
+
+	// highest level supported by CPU and OS
+	int detect()
+	{
+	#if defined(ICSTLIB_NO_SSEOPT)
+		return ISA_SSE2;
+	#elif defined(_MSC_VER)
+		int r[4];
+		__cpuid(r, 0);
+		if (r[0] < 7) return ISA_SSE2;
+		__cpuid(r, 1);
+		bool fma = (r[2] & (1 << 12)) != 0;
+		if (!(r[2] & (1 << 27))) return ISA_SSE2;		// OSXSAVE
+		unsigned long long xcr0 = _xgetbv(0);
+		__cpuidex(r, 7, 0);
+		if (((xcr0 & 0x06) != 0x06) || !fma || !(r[1] & (1 << 5))) {
+			return ISA_SSE2;
+		}
+		if (((xcr0 & 0xE0) == 0xE0) && (r[1] & (1 << 16))) return ISA_AVX512;
+		return ISA_AVX2;
+	#elif defined(__GNUC__)
+		__builtin_cpu_init();	// may run before static initialization
+		if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) {
+			return ISA_SSE2;
+		}
+		if (__builtin_cpu_supports("avx512f")) return ISA_AVX512;
+		return ISA_AVX2;
+	#else
+		return ISA_SSE2;
+	#endif
+	}
+
+	// level requested by ICSTDSP_ISA, ISA_AVX512 if not set
+	int envlimit()
+	{
+		const char* s = getenv("ICSTDSP_ISA");
+		if (s == NULL) return ISA_AVX512;
+		if (strcmp(s, "sse2") == 0) return ISA_SSE2;
+		if (strcmp(s, "avx2") == 0) return ISA_AVX2;
+		return ISA_AVX512;
+	}
+
+	// pick the best table up to level lim
+	const KernelTable* select(int lim)
+	{
+		int isa = detect();
+		if (isa > lim) isa = lim;
+		if ((isa >= ISA_AVX512) && (avx512::table != NULL)) {
+			activeisa.store(ISA_AVX512); return avx512::table;}
+		if ((isa >= ISA_AVX2) && (avx2::table != NULL)) {
+			activeisa.store(ISA_AVX2); return avx2::table;}
+		activeisa.store(ISA_SSE2); return sse2::table;
+	}
+}										// end anonymous namespace
+
+// concurrent first calls may select twice, with the same result
+const KernelTable& kernels()
+{
+	const KernelTable* k = active.load(std::memory_order_acquire);
+	if (k == NULL) {
+		isalimit.store(__min(isalimit.load(), envlimit()));
+		k = select(isalimit.load());
+		active.store(k, std::memory_order_release);
+	}
+	return *k;
+}
+
+int cpuisa()
+{
+	kernels();
+	return activeisa.load();
+}
+
+// not meant to be called while other threads run kernels
+int limitcpuisa(int isa)
+{
+	isalimit.store(__min(isa, envlimit()));
+	active.store(select(isalimit.load()), std::memory_order_release);
+	return activeisa.load();
+}
+
+}	// end library specific namespace
@@ -0,0 +1,104 @@
+// CpuDispatch.h
+// run time instruction set selection for the hot BlkDsp and AudioAnalysis
+// kernels, for internal use
+// !!! Must not be included before "common.h" !!!
+//
+// The library is compiled for SSE2. Kernels that profit from wider vectors
+// exist in additional versions compiled with AVX2+FMA (BlkDspAvx2.cpp) and
+// AVX-512F (BlkDspAvx512.cpp) flags. Each version provides a table of
+// function pointers, the public functions call through the table of the
+// best version the CPU and the OS support. The choice is made once, on the
+// first call, and can be limited with the environment variable ICSTDSP_ISA
+// (sse2, avx2, avx512) or BlkDsp::LimitCpuIsa.
+//
+// This code is part of the ICST DSP Library version 1.2. It is released
+// under the 2-clause BSD license. Copyright (c) 2008-2010, Zurich
+// University of the Arts, Beat Frei. All rights reserved.
+
+#ifndef _ICST_DSPLIB_CPUDISPATCH_INCLUDED
+#define _ICST_DSPLIB_CPUDISPATCH_INCLUDED
+
+namespace icstdsp {		// begin library specific namespace
+
+// instruction set levels, in ascending order
+enum {ISA_SSE2 = 0, ISA_AVX2 = 1, ISA_AVX512 = 2};
+
+// kernel table, semantics as the BlkDsp/AudioAnalysis functions of the
+// same name except:
+// cpxmacv:		cpxmac with vector r*s instead of c*r
+// trigwin:		d[i] = sum(k=0..order){p[k]*cos(pi + 2*pi*i/(size-1))^k}
+//				for i = 0..size/2, mirrored to d[size-1-i], size > 1
+// rfftsoa:	realfft (dir = 1) or realifft (dir = -1) of size 2m of f frames
+//				in SoA layout, tw: twiddle factors, s. FftSoa.h
+// envelope:	multi-channel follower, sample i of lane l at d[i*stride+l],
+//				processes lanes 0..lanes-1 of stride >= lanes
+struct KernelTable
+{
+	void (*addc)(float* d, float c, int size);
+	void (*add)(float* d, float* r, int size);
+	void (*mulc)(float* d, float c, int size);
+	void (*mul)(float* d, float* r, int size);
+	void (*mac)(float* d, float* r, float c, int size);
+	float (*dotp)(float* d, float* r, int size);
+	float (*sdist)(float* d, float* r, int size);
+	float (*energy)(float* d, int size);
+	void (*abs)(float* d, int size);
+	void (*fsqrt)(float* d, int size);
+	void (*logabs)(float* d, int size);
+	void (*cpxmulc)(float* d, cpx c, int size);
+	void (*cpxmul)(float* d, float* r, int size);
+	void (*cpxmac)(float* d, float* r, cpx c, int size);
+	void (*cpxmacv)(float* d, float* r, float* s, int size);
+	void (*cpxpow)(float* d, float* r, int size);
+	void (*cpxmag)(float* d, float* r, int size);
+	void (*trigwin)(float* d, int size, const double* p, int order);
+	void (*rfftsoa)(float* d, int m, int f, const float* tw, int dir);
+	void (*envelope)(float* d, float* r, float* c, int size, int lanes,
+						int stride, float* atime, float* rtime, int type);
+};
+
+// table of the selected instruction set
+const KernelTable& kernels();
+
+// selected instruction set level
+int cpuisa();
+
+// limit the instruction set level to at most isa, return the level in effect
+int limitcpuisa(int isa);
+
+// per instruction set implementations, the tables are NULL if the version
+// was not compiled with the required flags
+namespace sse2 {
+	void addc(float* d, float c, int size);
+	void add(float* d, float* r, int size);
+	void mulc(float* d, float c, int size);
+	void mul(float* d, float* r, int size);
+	void mac(float* d, float* r, float c, int size);
+	float dotp(float* d, float* r, int size);
+	float sdist(float* d, float* r, int size);
+	float energy(float* d, int size);
+	void abs(float* d, int size);
+	void fsqrt(float* d, int size);
+	void logabs(float* d, int size);
+	void cpxmulc(float* d, cpx c, int size);
+	void cpxmul(float* d, float* r, int size);
+	void cpxmac(float* d, float* r, cpx c, int size);
+	void cpxmacv(float* d, float* r, float* s, int size);
+	void cpxpow(float* d, float* r, int size);
+	void cpxmag(float* d, float* r, int size);
+	void trigwin(float* d, int size, const double* p, int order);
+	void rfftsoa(float* d, int m, int f, const float* tw, int dir);
+	void envelope(float* d, float* r, float* c, int size, int lanes,
+					int stride, float* atime, float* rtime, int type);
+	extern const KernelTable* const table;
+}
+namespace avx2 {
+	extern const KernelTable* const table;
+}
+namespace avx512 {
+	extern const KernelTable* const table;
+}
+
+}	// end library specific namespace
+
+#endif
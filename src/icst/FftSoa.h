@@ -0,0 +1,194 @@
+// FftSoa.h
+// batched real FFT core for frames in structure of arrays (SoA) layout,
+// for internal use by the instruction set specific kernels (CpuDispatch.h)
+// !!! Must not be included before "common.h" !!!
+//
+// Sample i of frame l is at d[i*f + l], so each row of f floats holds one
+// sample of all frames and every butterfly runs over whole rows, i.e. over
+// the frames in parallel SIMD lanes. Including translation units define a
+// vector class V and instantiate soarfft<V>:
+//	V::T		register type			V::W			lanes per register
+//	V::load(p)	unaligned load			V::store(p,x)	unaligned store
+//	V::set1(c)	broadcast
+//	V::add(a,b), V::sub(a,b), V::mul(a,b)
+//	V::madd(a,b,c) = a*b + c, V::msub(a,b,c) = a*b - c
+// Lanes that do not fill a register are processed by SoaScalar.
+//
+// The real transform of size n = 2m runs as a complex transform of size m
+// on z[j] = x[2j] + i*x[2j+1] (rows 2j,2j+1 = re,im), radix 2 DIT with two
+// stages fused per pass, followed (forward) or preceded (inverse) by the
+// split into the lower half spectrum. Data, twiddle and output formats:
+//	d:	in/out, m*2 rows, realfft/realifft format per frame
+//	tw:	W_m^t = cos(2*pi*t/m), -sin(2*pi*t/m), t = 0..m/2-1, followed by
+//		W_2m^k = cos(pi*k/m), -sin(pi*k/m), k = 0..m/2
+//	dir: 1 forward (realfft), -1 inverse (realifft, including 1/n scaling)
+//
+// This code is part of the ICST DSP Library version 1.2. It is released
+// under the 2-clause BSD license. Copyright (c) 2008-2010, Zurich
+// University of the Arts, Beat Frei. All rights reserved.
+
+#ifndef _ICST_DSPLIB_FFTSOA_INCLUDED
+#define _ICST_DSPLIB_FFTSOA_INCLUDED
+
+#include <algorithm>
+
+namespace icstdsp {		// begin library specific namespace
+namespace {								// begin anonymous namespace
+
+// one lane per register
+struct SoaScalar
+{
+	typedef float T;
+	enum {W = 1};
+	static T load(const float* p) {return *p;}
+	static void store(float* p, T x) {*p = x;}
+	static T set1(float c) {return c;}
+	static T add(T a, T b) {return a + b;}
+	static T sub(T a, T b) {return a - b;}
+	static T mul(T a, T b) {return a * b;}
+	static T madd(T a, T b, T c) {return a*b + c;}
+	static T msub(T a, T b, T c) {return a*b - c;}
+};
+
+// x*w -> x, complex
+template<class V> inline void soacmul(typename V::T& xr, typename V::T& xi,
+										typename V::T wr, typename V::T wi)
+{
+	typename V::T t = xr;
+	xr = V::msub(xr, wr, V::mul(xi, wi));
+	xi = V::madd(t, wi, V::mul(xi, wr));
+}
+
+// radix 2 butterflies of points a,b without twiddle, lanes k.. in steps
+// of V::W, return first unprocessed lane
+template<class V> inline int soabfly2(float* a, float* b, int f, int k)
+{
+	typename V::T ar,ai,br,bi;
+	for (; k<=(f-V::W); k+=V::W) {
+		ar = V::load(a+k); ai = V::load(a+f+k);
+		br = V::load(b+k); bi = V::load(b+f+k);
+		V::store(a+k, V::add(ar,br)); V::store(a+f+k, V::add(ai,bi));
+		V::store(b+k, V::sub(ar,br)); V::store(b+f+k, V::sub(ai,bi));
+	}
+	return k;
+}
+
+// two fused radix 2 stages on points a0..a3 (spaced by q): a0,a1 and a2,a3
+// with twiddle w2 = W_2q^j, then a0,a2 with w1 = W_4q^j and a1,a3 with
+// w3 = W_4q^(j+q), lanes k.. in steps of V::W, return first unprocessed lane
+template<class V> inline int soabfly4(float* a0, float* a1, float* a2, float* a3,
+									int f, int k, const float* w)
+{
+	typename V::T w1r = V::set1(w[0]), w1i = V::set1(w[1]);
+	typename V::T w2r = V::set1(w[2]), w2i = V::set1(w[3]);
+	typename V::T w3r = V::set1(w[4]), w3i = V::set1(w[5]);
+	typename V::T x0r,x0i,x1r,x1i,x2r,x2i,x3r,x3i,tr,ti;
+	for (; k<=(f-V::W); k+=V::W) {
+		x0r = V::load(a0+k); x0i = V::load(a0+f+k);
+		x1r = V::load(a1+k); x1i = V::load(a1+f+k);
+		x2r = V::load(a2+k); x2i = V::load(a2+f+k);
+		x3r = V::load(a3+k); x3i = V::load(a3+f+k);
+		soacmul<V>(x1r, x1i, w2r, w2i);
+		soacmul<V>(x3r, x3i, w2r, w2i);
+		tr = x0r; ti = x0i;
+		x0r = V::add(tr,x1r); x0i = V::add(ti,x1i);
+		x1r = V::sub(tr,x1r); x1i = V::sub(ti,x1i);
+		tr = x2r; ti = x2i;
+		x2r = V::add(tr,x3r); x2i = V::add(ti,x3i);
+		x3r = V::sub(tr,x3r); x3i = V::sub(ti,x3i);
+		soacmul<V>(x2r, x2i, w1r, w1i);
+		soacmul<V>(x3r, x3i, w3r, w3i);
+		V::store(a0+k, V::add(x0r,x2r)); V::store(a0+f+k, V::add(x0i,x2i));
+		V::store(a2+k, V::sub(x0r,x2r)); V::store(a2+f+k, V::sub(x0i,x2i));
+		V::store(a1+k, V::add(x1r,x3r)); V::store(a1+f+k, V::add(x1i,x3i));
+		V::store(a3+k, V::sub(x1r,x3r)); V::store(a3+f+k, V::sub(x1i,x3i));
+	}
+	return k;
+}
+
+// complex FFT of size m on rows, sgn = 1: forward, -1: inverse, unscaled
+template<class V> void soacfft(float* d, int m, int f, const float* tw, float sgn)
+{
+	int i,j,s,q,bit,tstep;
+	float* a; float w[6];
+	for (i=1, j=0; i<m; i++) {						// bit reversal of points
+		for (bit = m>>1; j & bit; bit >>= 1) {j ^= bit;}
+		j ^= bit;
+		if (i < j) {std::swap_ranges(d+2*i*f, d+2*(i+1)*f, d+2*j*f);}
+	}
+	q = 1;
+	for (s=m; s>1; s>>=2) {q = (s == 2) ? 2 : q;}
+	if (q == 2) {									// odd order: radix 2 first
+		for (s=0; s<m; s+=2) {
+			a = d + 2*s*f;
+			soabfly2<SoaScalar>(a, a+2*f, f, soabfly2<V>(a, a+2*f, f, 0));
+		}
+	}
+	for (; 4*q<=m; q<<=2) {
+		tstep = m/(4*q);
+		for (j=0; j<q; j++) {
+			w[0] = tw[2*j*tstep]; w[1] = sgn*tw[2*j*tstep+1];
+			w[2] = tw[4*j*tstep]; w[3] = sgn*tw[4*j*tstep+1];
+			w[4] = sgn*w[1]; w[5] = -sgn*w[0];		// w1*(-i), conj: w1*i
+			for (s=j; s<m; s+=4*q) {
+				a = d + 2*s*f;
+				soabfly4<SoaScalar>(a, a+2*q*f, a+4*q*f, a+6*q*f, f,
+					soabfly4<V>(a, a+2*q*f, a+4*q*f, a+6*q*f, f, 0, w), w);
+			}
+		}
+	}
+}
+
+// split spectrum Z of z into X of x (forward, c = 0.5) or merge X into
+// Z (inverse, c = 0.5/m), for the pair k,m-k with twiddle w = W_2m^k,
+// lanes l.. in steps of V::W, return first unprocessed lane
+template<class V> inline int soasplit(float* a, float* b, int f, int l,
+										float wr, float wi, float c, int dir)
+{
+	typename V::T vc = V::set1(c), vwr = V::set1(wr);
+	typename V::T vwi = V::set1((dir > 0) ? wi : -wi);	// w or conj(w)
+	typename V::T ar,ai,br,bi,er,ei,tr,ti;
+	for (; l<=(f-V::W); l+=V::W) {
+		ar = V::load(a+l); ai = V::load(a+f+l);
+		br = V::load(b+l); bi = V::load(b+f+l);		// conj(b) used below
+		er = V::mul(vc, V::add(ar,br)); ei = V::mul(vc, V::sub(ai,bi));
+		if (dir > 0) {								// t = w*(a-conj(b))/(2i)
+			tr = V::mul(vc, V::add(ai,bi)); ti = V::mul(vc, V::sub(br,ar));
+			soacmul<V>(tr, ti, vwr, vwi);
+		}
+		else {										// t = i*conj(w)*(a-conj(b))*c
+			ti = V::mul(vc, V::sub(ar,br)); tr = V::mul(vc, V::add(ai,bi));
+			soacmul<V>(ti, tr, vwr, vwi);
+			tr = V::sub(V::set1(0), tr);
+		}
+		V::store(a+l, V::add(er,tr)); V::store(a+f+l, V::add(ei,ti));
+		V::store(b+l, V::sub(er,tr)); V::store(b+f+l, V::sub(ti,ei));
+	}
+	return l;
+}
+
+// real FFT of size 2m on all f frames, formats see above
+template<class V> void soarfft(float* d, int m, int f, const float* tw, int dir)
+{
+	int k,l;
+	float* a; float* b;
+	const float* pw = tw + 2*(m>>1);
+	float c = (dir > 0) ? 0.5f : 0.5f/static_cast<float>(m);
+	if (dir > 0) {soacfft<V>(d, m, f, tw, 1.0f);}
+	for (l=0; l<f; l++) {							// X[0], X[m] <-> Z[0]
+		float x = d[l], y = d[f+l];
+		d[l] = (dir > 0) ? (x + y) : c*(x + y);
+		d[f+l] = (dir > 0) ? (x - y) : c*(x - y);
+	}
+	for (k=1; k<=(m>>1); k++) {
+		a = d + 2*k*f; b = d + 2*(m-k)*f;
+		soasplit<SoaScalar>(a, b, f, soasplit<V>(a, b, f, 0, pw[2*k], pw[2*k+1],
+							c, dir), pw[2*k], pw[2*k+1], c, dir);
+	}
+	if (dir < 0) {soacfft<V>(d, m, f, tw, -1.0f);}
+}
+
+}										// end anonymous namespace
+}	// end library specific namespace
+
+#endif
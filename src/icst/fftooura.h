@@ -1,8 +1,8 @@
 // fftooura.h
 // header for Ooura's FFT package (www.kurims.kyoto-u.ac.jp/~ooura)
 // n: size, isgn: 1=fwd,-1=inv, a:data, details see fftoouraf.cpp
-// uses versions without workspace (no dynamic memory needed, 10% slower)
-// multithreading not supported yet
+// twiddle factors are taken from tables that are built on first use of
+// a size and shared by all threads, calls may run concurrently
 // License (as found on his homepage, 28.7.08): 
 // *** Copyright Takuya OOURA, 1996-2001
 // You may use, copy, modify and distribute this code for any purpose 
@@ -30,6 +30,8 @@ void dfct(int n, double *a);				// real data symmetric DFT
 void dfct(int n, float *a);
 void dfst(int n, double *a);				// real data asymmetric DFT
 void dfst(int n, float *a);
+void fftprepare(int n, double *a);			// build tables up to size n in
+void fftprepare(int n, float *a);			// advance, a: unused (precision)
 
 }	// end library specific namespace
 
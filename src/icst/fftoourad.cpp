@@ -6,7 +6,9 @@
 
 #include "Common.h"
 #include "fftooura.h"
+#include "CritSect.h"
 #include <cmath>
+#include <atomic>
 
 namespace icstdsp {		// begin library specific namespace 
 
@@ -40,6 +42,106 @@ void cftrec4(int n, double *a);
 void cftx020(double *a);
 int cfttree(int n, int j, int k, double *a);
 
+namespace {		// twiddle factor tables
+
+// The kernels read their twiddle factors from tables instead of running
+// trigonometric recurrences on every call. The tables of a size are
+// computed once in double precision and kept for the lifetime of the
+// process (about 1.25*n values per size, all sizes up to the largest).
+// They are built by prepare() at each public entry point and only read
+// afterwards, so concurrent transforms need no further locking.
+
+const int TABLE_LEVELS = 32;
+
+double* tab1[TABLE_LEVELS];				// cftmdl1, cftb1st
+double* tab2[TABLE_LEVELS];				// cftmdl2
+double* tabr[TABLE_LEVELS];				// rftfsub, rftbsub
+std::atomic<int> tablevels(0);			// levels 0..tablevels-1 are ready
+
+int ilog2(int n)
+{
+	int l = 0;
+	while ((1 << l) < n) l++;
+	return l;
+}
+
+// n/4 values for size n: per even j in [0,n/8), the pair w1 = exp(i*2*pi*j/n)
+// and w3 = exp(-i*6*pi*j/n)
+double* maketab1(int n)
+{
+	int mh = n >> 3, j;
+	double* w = new double[2*mh];
+	double ew = 2.0*M_PI/static_cast<double>(n);
+	for (j=0; j<mh-1; j+=2) {
+		w[2*j] = static_cast<double>(cos(ew*j));
+		w[2*j+1] = static_cast<double>(sin(ew*j));
+		w[2*j+2] = static_cast<double>(cos(3.0*ew*j));
+		w[2*j+3] = static_cast<double>(-sin(3.0*ew*j));
+	}
+	return w;
+}
+
+// n/2 values for size n: per even j in [0,n/8), w1 = exp(i*pi*j/n), w3 = conj(w1^3)
+// and the same two rotated by +pi/4 and -3*pi/4 respectively
+double* maketab2(int n)
+{
+	int mh = n >> 3, j;
+	double* w = new double[4*mh];
+	double ew = M_PI/static_cast<double>(n);
+	for (j=0; j<mh-1; j+=2) {
+		w[4*j] = static_cast<double>(cos(ew*j));
+		w[4*j+1] = static_cast<double>(sin(ew*j));
+		w[4*j+2] = static_cast<double>(cos(3.0*ew*j));
+		w[4*j+3] = static_cast<double>(-sin(3.0*ew*j));
+		w[4*j+4] = static_cast<double>(cos(ew*j + M_PI_4));
+		w[4*j+5] = static_cast<double>(sin(ew*j + M_PI_4));
+		w[4*j+6] = static_cast<double>(cos(-3.0*ew*j - 3.0*M_PI_4));
+		w[4*j+7] = static_cast<double>(sin(-3.0*ew*j - 3.0*M_PI_4));
+	}
+	return w;
+}
+
+// n/2+2 values for size n: per even j in [0,n/2], 0.5 - 0.5*sin(pi*j/n)
+// and 0.5*cos(pi*j/n)
+double* maketabr(int n)
+{
+	int j;
+	double* w = new double[(n >> 1) + 2];
+	double ec = M_PI/static_cast<double>(n);
+	for (j=0; j<=(n >> 1); j+=2) {
+		w[j] = static_cast<double>(0.5 - 0.5*sin(ec*j));
+		w[j+1] = static_cast<double>(0.5*cos(ec*j));
+	}
+	return w;
+}
+
+// make tables for all power of 2 sizes up to n available
+void prepare(int n)
+{
+	static CriticalSection cs;
+	int l, levels = ilog2(n) + 1;
+	if (tablevels.load(std::memory_order_acquire) >= levels) return;
+	cs.Enter();
+	for (l=tablevels.load(std::memory_order_relaxed); l<levels; l++) {
+		tab1[l] = maketab1(1 << l);
+		tab2[l] = maketab2(1 << l);
+		tabr[l] = maketabr(1 << l);
+	}
+	if (tablevels.load(std::memory_order_relaxed) < levels) {
+		tablevels.store(levels, std::memory_order_release);
+	}
+	cs.Leave();
+}
+
+inline const double* cfttab1(int n) {return tab1[ilog2(n)];}
+inline const double* cfttab2(int n) {return tab2[ilog2(n)];}
+inline const double* rfttab(int n) {return tabr[ilog2(n)];}
+
+}	// end twiddle factor tables
+
+// build the tables of all sizes up to n in advance
+void fftprepare(int n, double *) {prepare(n);}
+
 /*
 Fast Fourier/Cosine/Sine Transform
     dimension   :one
@@ -47,7 +149,7 @@ Fast Fourier/Cosine/Sine Transform
     decimation  :frequency
     radix       :split-radix
     data        :inplace
-    table       :not use
+    table       :internal, cached per size
 functions
     cdft: Complex Discrete Fourier Transform
     rdft: Real Discrete Fourier Transform
@@ -253,6 +355,7 @@ function prototypes
 
 void cdft(int n, int isgn, double *a)
 {
+    prepare(n);
     if (isgn >= 0) {
         cftfsub(n, a);
     } else {
@@ -265,6 +368,7 @@ void rdft(int n, int isgn, double *a)
 {
     double xi;
     
+    prepare(n);
     if (isgn >= 0) {
         if (n > 4) {
             cftfsub(n, a);
@@ -293,6 +397,7 @@ void ddct(int n, int isgn, double *a)
     int j;
     double xr;
     
+    prepare(n);
     if (isgn < 0) {
         xr = a[n - 1];
         for (j = n - 2; j >= 2; j -= 2) {
@@ -336,6 +441,7 @@ void ddst(int n, int isgn, double *a)
     int j;
     double xr;
     
+    prepare(n);
     if (isgn < 0) {
         xr = a[n - 1];
         for (j = n - 2; j >= 2; j -= 2) {
@@ -494,14 +600,6 @@ void dfst(int n, double *a)
 #endif
 
 
-#ifndef CDFT_LOOP_DIV  /* control of the CDFT's speed & tolerance */
-	#define CDFT_LOOP_DIV 32
-#endif
-
-#ifndef RDFT_LOOP_DIV  /* control of the RDFT's speed & tolerance */
-	#define RDFT_LOOP_DIV 64
-#endif
-
 #ifndef DCST_LOOP_DIV  /* control of the DCT,DST's speed & tolerance */
 	#define DCST_LOOP_DIV 64
 #endif
@@ -1572,9 +1670,9 @@ void bitrv1(int n, double *a)
 
 void cftb1st(int n, double *a)
 {
-    int i, i0, j, j0, j1, j2, j3, m, mh;
-    double ew, w1r, w1i, wk1r, wk1i, wk3r, wk3i, 
-        wd1r, wd1i, wd3r, wd3i, ss1, ss3;
+    int j, j0, j1, j2, j3, m, mh;
+    const double *w;
+    double wk1r, wk1i, wk3r, wk3i, wd1r, wd1i, wd3r, wd3i;
     double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
     mh = n >> 3;
@@ -1598,138 +1696,108 @@ void cftb1st(int n, double *a)
     a[j2 + 1] = x1i + x3r;
     a[j3] = x1r - x3i;
     a[j3 + 1] = x1i - x3r;
-    wd1r = 1;
-    wd1i = 0;
-    wd3r = 1;
-    wd3i = 0;
-    ew = M_PI_2 / m;
-    w1r = cos(2 * ew);
-    w1i = sin(2 * ew);
-    wk1r = w1r;
-    wk1i = w1i;
-    ss1 = 2 * w1i;
-    wk3i = 2 * ss1 * wk1r;
-    wk3r = wk1r - wk3i * wk1i;
-    wk3i = wk1i - wk3i * wk1r;
-    ss3 = 2 * wk3i;
-    i = 0;
-    for (;;) {
-        i0 = i + 4 * CDFT_LOOP_DIV;
-        if (i0 > mh - 4) {
-            i0 = mh - 4;
-        }
-        for (j = i + 2; j < i0; j += 4) {
-            wd1r -= ss1 * wk1i;
-            wd1i += ss1 * wk1r;
-            wd3r -= ss3 * wk3i;
-            wd3i += ss3 * wk3r;
-            j1 = j + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j] + a[j2];
-            x0i = -a[j + 1] - a[j2 + 1];
-            x1r = a[j] - a[j2];
-            x1i = -a[j + 1] + a[j2 + 1];
-            x2r = a[j1] + a[j3];
-            x2i = a[j1 + 1] + a[j3 + 1];
-            x3r = a[j1] - a[j3];
-            x3i = a[j1 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i - x2i;
-            a[j1] = x0r - x2r;
-            a[j1 + 1] = x0i + x2i;
-            x0r = x1r + x3i;
-            x0i = x1i + x3r;
-            a[j2] = wk1r * x0r - wk1i * x0i;
-            a[j2 + 1] = wk1r * x0i + wk1i * x0r;
-            x0r = x1r - x3i;
-            x0i = x1i - x3r;
-            a[j3] = wk3r * x0r + wk3i * x0i;
-            a[j3 + 1] = wk3r * x0i - wk3i * x0r;
-            x0r = a[j + 2] + a[j2 + 2];
-            x0i = -a[j + 3] - a[j2 + 3];
-            x1r = a[j + 2] - a[j2 + 2];
-            x1i = -a[j + 3] + a[j2 + 3];
-            x2r = a[j1 + 2] + a[j3 + 2];
-            x2i = a[j1 + 3] + a[j3 + 3];
-            x3r = a[j1 + 2] - a[j3 + 2];
-            x3i = a[j1 + 3] - a[j3 + 3];
-            a[j + 2] = x0r + x2r;
-            a[j + 3] = x0i - x2i;
-            a[j1 + 2] = x0r - x2r;
-            a[j1 + 3] = x0i + x2i;
-            x0r = x1r + x3i;
-            x0i = x1i + x3r;
-            a[j2 + 2] = wd1r * x0r - wd1i * x0i;
-            a[j2 + 3] = wd1r * x0i + wd1i * x0r;
-            x0r = x1r - x3i;
-            x0i = x1i - x3r;
-            a[j3 + 2] = wd3r * x0r + wd3i * x0i;
-            a[j3 + 3] = wd3r * x0i - wd3i * x0r;
-            j0 = m - j;
-            j1 = j0 + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j0] + a[j2];
-            x0i = -a[j0 + 1] - a[j2 + 1];
-            x1r = a[j0] - a[j2];
-            x1i = -a[j0 + 1] + a[j2 + 1];
-            x2r = a[j1] + a[j3];
-            x2i = a[j1 + 1] + a[j3 + 1];
-            x3r = a[j1] - a[j3];
-            x3i = a[j1 + 1] - a[j3 + 1];
-            a[j0] = x0r + x2r;
-            a[j0 + 1] = x0i - x2i;
-            a[j1] = x0r - x2r;
-            a[j1 + 1] = x0i + x2i;
-            x0r = x1r + x3i;
-            x0i = x1i + x3r;
-            a[j2] = wk1i * x0r - wk1r * x0i;
-            a[j2 + 1] = wk1i * x0i + wk1r * x0r;
-            x0r = x1r - x3i;
-            x0i = x1i - x3r;
-            a[j3] = wk3i * x0r + wk3r * x0i;
-            a[j3 + 1] = wk3i * x0i - wk3r * x0r;
-            x0r = a[j0 - 2] + a[j2 - 2];
-            x0i = -a[j0 - 1] - a[j2 - 1];
-            x1r = a[j0 - 2] - a[j2 - 2];
-            x1i = -a[j0 - 1] + a[j2 - 1];
-            x2r = a[j1 - 2] + a[j3 - 2];
-            x2i = a[j1 - 1] + a[j3 - 1];
-            x3r = a[j1 - 2] - a[j3 - 2];
-            x3i = a[j1 - 1] - a[j3 - 1];
-            a[j0 - 2] = x0r + x2r;
-            a[j0 - 1] = x0i - x2i;
-            a[j1 - 2] = x0r - x2r;
-            a[j1 - 1] = x0i + x2i;
-            x0r = x1r + x3i;
-            x0i = x1i + x3r;
-            a[j2 - 2] = wd1i * x0r - wd1r * x0i;
-            a[j2 - 1] = wd1i * x0i + wd1r * x0r;
-            x0r = x1r - x3i;
-            x0i = x1i - x3r;
-            a[j3 - 2] = wd3i * x0r + wd3r * x0i;
-            a[j3 - 1] = wd3i * x0i - wd3r * x0r;
-            wk1r -= ss1 * wd1i;
-            wk1i += ss1 * wd1r;
-            wk3r -= ss3 * wd3i;
-            wk3i += ss3 * wd3r;
-        }
-        if (i0 == mh - 4) {
-            break;
-        }
-        wd1r = cos(ew * i0);
-        wd1i = sin(ew * i0);
-        wd3i = 4 * wd1i * wd1r;
-        wd3r = wd1r - wd3i * wd1i;
-        wd3i = wd1i - wd3i * wd1r;
-        wk1r = w1r * wd1r - w1i * wd1i;
-        wk1i = w1r * wd1i + w1i * wd1r;
-        wk3i = 4 * wk1i * wk1r;
-        wk3r = wk1r - wk3i * wk1i;
-        wk3i = wk1i - wk3i * wk1r;
-        i = i0;
+    w = cfttab1(n);
+    for (j = 2; j < mh - 4; j += 4) {
+        wk1r = w[2 * j];
+        wk1i = w[2 * j + 1];
+        wk3r = w[2 * j + 2];
+        wk3i = w[2 * j + 3];
+        wd1r = w[2 * j + 4];
+        wd1i = w[2 * j + 5];
+        wd3r = w[2 * j + 6];
+        wd3i = w[2 * j + 7];
+        j1 = j + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j] + a[j2];
+        x0i = -a[j + 1] - a[j2 + 1];
+        x1r = a[j] - a[j2];
+        x1i = -a[j + 1] + a[j2 + 1];
+        x2r = a[j1] + a[j3];
+        x2i = a[j1 + 1] + a[j3 + 1];
+        x3r = a[j1] - a[j3];
+        x3i = a[j1 + 1] - a[j3 + 1];
+        a[j] = x0r + x2r;
+        a[j + 1] = x0i - x2i;
+        a[j1] = x0r - x2r;
+        a[j1 + 1] = x0i + x2i;
+        x0r = x1r + x3i;
+        x0i = x1i + x3r;
+        a[j2] = wk1r * x0r - wk1i * x0i;
+        a[j2 + 1] = wk1r * x0i + wk1i * x0r;
+        x0r = x1r - x3i;
+        x0i = x1i - x3r;
+        a[j3] = wk3r * x0r + wk3i * x0i;
+        a[j3 + 1] = wk3r * x0i - wk3i * x0r;
+        x0r = a[j + 2] + a[j2 + 2];
+        x0i = -a[j + 3] - a[j2 + 3];
+        x1r = a[j + 2] - a[j2 + 2];
+        x1i = -a[j + 3] + a[j2 + 3];
+        x2r = a[j1 + 2] + a[j3 + 2];
+        x2i = a[j1 + 3] + a[j3 + 3];
+        x3r = a[j1 + 2] - a[j3 + 2];
+        x3i = a[j1 + 3] - a[j3 + 3];
+        a[j + 2] = x0r + x2r;
+        a[j + 3] = x0i - x2i;
+        a[j1 + 2] = x0r - x2r;
+        a[j1 + 3] = x0i + x2i;
+        x0r = x1r + x3i;
+        x0i = x1i + x3r;
+        a[j2 + 2] = wd1r * x0r - wd1i * x0i;
+        a[j2 + 3] = wd1r * x0i + wd1i * x0r;
+        x0r = x1r - x3i;
+        x0i = x1i - x3r;
+        a[j3 + 2] = wd3r * x0r + wd3i * x0i;
+        a[j3 + 3] = wd3r * x0i - wd3i * x0r;
+        j0 = m - j;
+        j1 = j0 + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j0] + a[j2];
+        x0i = -a[j0 + 1] - a[j2 + 1];
+        x1r = a[j0] - a[j2];
+        x1i = -a[j0 + 1] + a[j2 + 1];
+        x2r = a[j1] + a[j3];
+        x2i = a[j1 + 1] + a[j3 + 1];
+        x3r = a[j1] - a[j3];
+        x3i = a[j1 + 1] - a[j3 + 1];
+        a[j0] = x0r + x2r;
+        a[j0 + 1] = x0i - x2i;
+        a[j1] = x0r - x2r;
+        a[j1 + 1] = x0i + x2i;
+        x0r = x1r + x3i;
+        x0i = x1i + x3r;
+        a[j2] = wk1i * x0r - wk1r * x0i;
+        a[j2 + 1] = wk1i * x0i + wk1r * x0r;
+        x0r = x1r - x3i;
+        x0i = x1i - x3r;
+        a[j3] = wk3i * x0r + wk3r * x0i;
+        a[j3 + 1] = wk3i * x0i - wk3r * x0r;
+        x0r = a[j0 - 2] + a[j2 - 2];
+        x0i = -a[j0 - 1] - a[j2 - 1];
+        x1r = a[j0 - 2] - a[j2 - 2];
+        x1i = -a[j0 - 1] + a[j2 - 1];
+        x2r = a[j1 - 2] + a[j3 - 2];
+        x2i = a[j1 - 1] + a[j3 - 1];
+        x3r = a[j1 - 2] - a[j3 - 2];
+        x3i = a[j1 - 1] - a[j3 - 1];
+        a[j0 - 2] = x0r + x2r;
+        a[j0 - 1] = x0i - x2i;
+        a[j1 - 2] = x0r - x2r;
+        a[j1 - 1] = x0i + x2i;
+        x0r = x1r + x3i;
+        x0i = x1i + x3r;
+        a[j2 - 2] = wd1i * x0r - wd1r * x0i;
+        a[j2 - 1] = wd1i * x0i + wd1r * x0r;
+        x0r = x1r - x3i;
+        x0i = x1i - x3r;
+        a[j3 - 2] = wd3i * x0r + wd3r * x0i;
+        a[j3 - 1] = wd3i * x0i - wd3r * x0r;
     }
+    wk1r = w[2 * mh - 4];
+    wk1i = w[2 * mh - 3];
+    wk3r = w[2 * mh - 2];
+    wk3i = w[2 * mh - 1];
     wd1r = WR5000;
     j0 = mh;
     j1 = j0 + m;
@@ -1910,9 +1978,9 @@ void cftleaf(int n, int isplt, double *a)
 
 void cftmdl1(int n, double *a)
 {
-    int i, i0, j, j0, j1, j2, j3, m, mh;
-    double ew, w1r, w1i, wk1r, wk1i, wk3r, wk3i, 
-        wd1r, wd1i, wd3r, wd3i, ss1, ss3;
+    int j, j0, j1, j2, j3, m, mh;
+    const double *w;
+    double wk1r, wk1i, wk3r, wk3i, wd1r, wd1i, wd3r, wd3i;
     double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
     mh = n >> 3;
@@ -1936,138 +2004,108 @@ void cftmdl1(int n, double *a)
     a[j2 + 1] = x1i + x3r;
     a[j3] = x1r + x3i;
     a[j3 + 1] = x1i - x3r;
-    wd1r = 1;
-    wd1i = 0;
-    wd3r = 1;
-    wd3i = 0;
-    ew = M_PI_2 / m;
-    w1r = cos(2 * ew);
-    w1i = sin(2 * ew);
-    wk1r = w1r;
-    wk1i = w1i;
-    ss1 = 2 * w1i;
-    wk3i = 2 * ss1 * wk1r;
-    wk3r = wk1r - wk3i * wk1i;
-    wk3i = wk1i - wk3i * wk1r;
-    ss3 = 2 * wk3i;
-    i = 0;
-    for (;;) {
-        i0 = i + 4 * CDFT_LOOP_DIV;
-        if (i0 > mh - 4) {
-            i0 = mh - 4;
-        }
-        for (j = i + 2; j < i0; j += 4) {
-            wd1r -= ss1 * wk1i;
-            wd1i += ss1 * wk1r;
-            wd3r -= ss3 * wk3i;
-            wd3i += ss3 * wk3r;
-            j1 = j + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j] + a[j2];
-            x0i = a[j + 1] + a[j2 + 1];
-            x1r = a[j] - a[j2];
-            x1i = a[j + 1] - a[j2 + 1];
-            x2r = a[j1] + a[j3];
-            x2i = a[j1 + 1] + a[j3 + 1];
-            x3r = a[j1] - a[j3];
-            x3i = a[j1 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i + x2i;
-            a[j1] = x0r - x2r;
-            a[j1 + 1] = x0i - x2i;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j2] = wk1r * x0r - wk1i * x0i;
-            a[j2 + 1] = wk1r * x0i + wk1i * x0r;
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3] = wk3r * x0r + wk3i * x0i;
-            a[j3 + 1] = wk3r * x0i - wk3i * x0r;
-            x0r = a[j + 2] + a[j2 + 2];
-            x0i = a[j + 3] + a[j2 + 3];
-            x1r = a[j + 2] - a[j2 + 2];
-            x1i = a[j + 3] - a[j2 + 3];
-            x2r = a[j1 + 2] + a[j3 + 2];
-            x2i = a[j1 + 3] + a[j3 + 3];
-            x3r = a[j1 + 2] - a[j3 + 2];
-            x3i = a[j1 + 3] - a[j3 + 3];
-            a[j + 2] = x0r + x2r;
-            a[j + 3] = x0i + x2i;
-            a[j1 + 2] = x0r - x2r;
-            a[j1 + 3] = x0i - x2i;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j2 + 2] = wd1r * x0r - wd1i * x0i;
-            a[j2 + 3] = wd1r * x0i + wd1i * x0r;
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3 + 2] = wd3r * x0r + wd3i * x0i;
-            a[j3 + 3] = wd3r * x0i - wd3i * x0r;
-            j0 = m - j;
-            j1 = j0 + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j0] + a[j2];
-            x0i = a[j0 + 1] + a[j2 + 1];
-            x1r = a[j0] - a[j2];
-            x1i = a[j0 + 1] - a[j2 + 1];
-            x2r = a[j1] + a[j3];
-            x2i = a[j1 + 1] + a[j3 + 1];
-            x3r = a[j1] - a[j3];
-            x3i = a[j1 + 1] - a[j3 + 1];
-            a[j0] = x0r + x2r;
-            a[j0 + 1] = x0i + x2i;
-            a[j1] = x0r - x2r;
-            a[j1 + 1] = x0i - x2i;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j2] = wk1i * x0r - wk1r * x0i;
-            a[j2 + 1] = wk1i * x0i + wk1r * x0r;
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3] = wk3i * x0r + wk3r * x0i;
-            a[j3 + 1] = wk3i * x0i - wk3r * x0r;
-            x0r = a[j0 - 2] + a[j2 - 2];
-            x0i = a[j0 - 1] + a[j2 - 1];
-            x1r = a[j0 - 2] - a[j2 - 2];
-            x1i = a[j0 - 1] - a[j2 - 1];
-            x2r = a[j1 - 2] + a[j3 - 2];
-            x2i = a[j1 - 1] + a[j3 - 1];
-            x3r = a[j1 - 2] - a[j3 - 2];
-            x3i = a[j1 - 1] - a[j3 - 1];
-            a[j0 - 2] = x0r + x2r;
-            a[j0 - 1] = x0i + x2i;
-            a[j1 - 2] = x0r - x2r;
-            a[j1 - 1] = x0i - x2i;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j2 - 2] = wd1i * x0r - wd1r * x0i;
-            a[j2 - 1] = wd1i * x0i + wd1r * x0r;
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3 - 2] = wd3i * x0r + wd3r * x0i;
-            a[j3 - 1] = wd3i * x0i - wd3r * x0r;
-            wk1r -= ss1 * wd1i;
-            wk1i += ss1 * wd1r;
-            wk3r -= ss3 * wd3i;
-            wk3i += ss3 * wd3r;
-        }
-        if (i0 == mh - 4) {
-            break;
-        }
-        wd1r = cos(ew * i0);
-        wd1i = sin(ew * i0);
-        wd3i = 4 * wd1i * wd1r;
-        wd3r = wd1r - wd3i * wd1i;
-        wd3i = wd1i - wd3i * wd1r;
-        wk1r = w1r * wd1r - w1i * wd1i;
-        wk1i = w1r * wd1i + w1i * wd1r;
-        wk3i = 4 * wk1i * wk1r;
-        wk3r = wk1r - wk3i * wk1i;
-        wk3i = wk1i - wk3i * wk1r;
-        i = i0;
+    w = cfttab1(n);
+    for (j = 2; j < mh - 4; j += 4) {
+        wk1r = w[2 * j];
+        wk1i = w[2 * j + 1];
+        wk3r = w[2 * j + 2];
+        wk3i = w[2 * j + 3];
+        wd1r = w[2 * j + 4];
+        wd1i = w[2 * j + 5];
+        wd3r = w[2 * j + 6];
+        wd3i = w[2 * j + 7];
+        j1 = j + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j] + a[j2];
+        x0i = a[j + 1] + a[j2 + 1];
+        x1r = a[j] - a[j2];
+        x1i = a[j + 1] - a[j2 + 1];
+        x2r = a[j1] + a[j3];
+        x2i = a[j1 + 1] + a[j3 + 1];
+        x3r = a[j1] - a[j3];
+        x3i = a[j1 + 1] - a[j3 + 1];
+        a[j] = x0r + x2r;
+        a[j + 1] = x0i + x2i;
+        a[j1] = x0r - x2r;
+        a[j1 + 1] = x0i - x2i;
+        x0r = x1r - x3i;
+        x0i = x1i + x3r;
+        a[j2] = wk1r * x0r - wk1i * x0i;
+        a[j2 + 1] = wk1r * x0i + wk1i * x0r;
+        x0r = x1r + x3i;
+        x0i = x1i - x3r;
+        a[j3] = wk3r * x0r + wk3i * x0i;
+        a[j3 + 1] = wk3r * x0i - wk3i * x0r;
+        x0r = a[j + 2] + a[j2 + 2];
+        x0i = a[j + 3] + a[j2 + 3];
+        x1r = a[j + 2] - a[j2 + 2];
+        x1i = a[j + 3] - a[j2 + 3];
+        x2r = a[j1 + 2] + a[j3 + 2];
+        x2i = a[j1 + 3] + a[j3 + 3];
+        x3r = a[j1 + 2] - a[j3 + 2];
+        x3i = a[j1 + 3] - a[j3 + 3];
+        a[j + 2] = x0r + x2r;
+        a[j + 3] = x0i + x2i;
+        a[j1 + 2] = x0r - x2r;
+        a[j1 + 3] = x0i - x2i;
+        x0r = x1r - x3i;
+        x0i = x1i + x3r;
+        a[j2 + 2] = wd1r * x0r - wd1i * x0i;
+        a[j2 + 3] = wd1r * x0i + wd1i * x0r;
+        x0r = x1r + x3i;
+        x0i = x1i - x3r;
+        a[j3 + 2] = wd3r * x0r + wd3i * x0i;
+        a[j3 + 3] = wd3r * x0i - wd3i * x0r;
+        j0 = m - j;
+        j1 = j0 + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j0] + a[j2];
+        x0i = a[j0 + 1] + a[j2 + 1];
+        x1r = a[j0] - a[j2];
+        x1i = a[j0 + 1] - a[j2 + 1];
+        x2r = a[j1] + a[j3];
+        x2i = a[j1 + 1] + a[j3 + 1];
+        x3r = a[j1] - a[j3];
+        x3i = a[j1 + 1] - a[j3 + 1];
+        a[j0] = x0r + x2r;
+        a[j0 + 1] = x0i + x2i;
+        a[j1] = x0r - x2r;
+        a[j1 + 1] = x0i - x2i;
+        x0r = x1r - x3i;
+        x0i = x1i + x3r;
+        a[j2] = wk1i * x0r - wk1r * x0i;
+        a[j2 + 1] = wk1i * x0i + wk1r * x0r;
+        x0r = x1r + x3i;
+        x0i = x1i - x3r;
+        a[j3] = wk3i * x0r + wk3r * x0i;
+        a[j3 + 1] = wk3i * x0i - wk3r * x0r;
+        x0r = a[j0 - 2] + a[j2 - 2];
+        x0i = a[j0 - 1] + a[j2 - 1];
+        x1r = a[j0 - 2] - a[j2 - 2];
+        x1i = a[j0 - 1] - a[j2 - 1];
+        x2r = a[j1 - 2] + a[j3 - 2];
+        x2i = a[j1 - 1] + a[j3 - 1];
+        x3r = a[j1 - 2] - a[j3 - 2];
+        x3i = a[j1 - 1] - a[j3 - 1];
+        a[j0 - 2] = x0r + x2r;
+        a[j0 - 1] = x0i + x2i;
+        a[j1 - 2] = x0r - x2r;
+        a[j1 - 1] = x0i - x2i;
+        x0r = x1r - x3i;
+        x0i = x1i + x3r;
+        a[j2 - 2] = wd1i * x0r - wd1r * x0i;
+        a[j2 - 1] = wd1i * x0i + wd1r * x0r;
+        x0r = x1r + x3i;
+        x0i = x1i - x3r;
+        a[j3 - 2] = wd3i * x0r + wd3r * x0i;
+        a[j3 - 1] = wd3i * x0i - wd3r * x0r;
     }
+    wk1r = w[2 * mh - 4];
+    wk1i = w[2 * mh - 3];
+    wk3r = w[2 * mh - 2];
+    wk3i = w[2 * mh - 1];
     wd1r = WR5000;
     j0 = mh;
     j1 = j0 + m;
@@ -2138,10 +2176,11 @@ void cftmdl1(int n, double *a)
 
 void cftmdl2(int n, double *a)
 {
-    int i, i0, j, j0, j1, j2, j3, m, mh;
-    double ew, w1r, w1i, wn4r, wk1r, wk1i, wk3r, wk3i, 
+    int j, j0, j1, j2, j3, m, mh;
+    const double *w;
+    double wn4r, wk1r, wk1i, wk3r, wk3i, 
         wl1r, wl1i, wl3r, wl3i, wd1r, wd1i, wd3r, wd3i, 
-        we1r, we1i, we3r, we3i, ss1, ss3;
+        we1r, we1i, we3r, we3i;
     double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i, y0r, y0i, y2r, y2i;
     
     mh = n >> 3;
@@ -2170,178 +2209,136 @@ void cftmdl2(int n, double *a)
     a[j2 + 1] = x1i + y0r;
     a[j3] = x1r + y0i;
     a[j3 + 1] = x1i - y0r;
-    wl1r = 1;
-    wl1i = 0;
-    wl3r = 1;
-    wl3i = 0;
-    we1r = wn4r;
-    we1i = wn4r;
-    we3r = -wn4r;
-    we3i = -wn4r;
-    ew = M_PI_2 / (2 * m);
-    w1r = cos(2 * ew);
-    w1i = sin(2 * ew);
-    wk1r = w1r;
-    wk1i = w1i;
-    wd1r = wn4r * (w1r - w1i);
-    wd1i = wn4r * (w1i + w1r);
-    ss1 = 2 * w1i;
-    wk3i = 2 * ss1 * wk1r;
-    wk3r = wk1r - wk3i * wk1i;
-    wk3i = wk1i - wk3i * wk1r;
-    ss3 = 2 * wk3i;
-    wd3r = -wn4r * (wk3r - wk3i);
-    wd3i = -wn4r * (wk3i + wk3r);
-    i = 0;
-    for (;;) {
-        i0 = i + 4 * CDFT_LOOP_DIV;
-        if (i0 > mh - 4) {
-            i0 = mh - 4;
-        }
-        for (j = i + 2; j < i0; j += 4) {
-            wl1r -= ss1 * wk1i;
-            wl1i += ss1 * wk1r;
-            wl3r -= ss3 * wk3i;
-            wl3i += ss3 * wk3r;
-            we1r -= ss1 * wd1i;
-            we1i += ss1 * wd1r;
-            we3r -= ss3 * wd3i;
-            we3i += ss3 * wd3r;
-            j1 = j + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j] - a[j2 + 1];
-            x0i = a[j + 1] + a[j2];
-            x1r = a[j] + a[j2 + 1];
-            x1i = a[j + 1] - a[j2];
-            x2r = a[j1] - a[j3 + 1];
-            x2i = a[j1 + 1] + a[j3];
-            x3r = a[j1] + a[j3 + 1];
-            x3i = a[j1 + 1] - a[j3];
-            y0r = wk1r * x0r - wk1i * x0i;
-            y0i = wk1r * x0i + wk1i * x0r;
-            y2r = wd1r * x2r - wd1i * x2i;
-            y2i = wd1r * x2i + wd1i * x2r;
-            a[j] = y0r + y2r;
-            a[j + 1] = y0i + y2i;
-            a[j1] = y0r - y2r;
-            a[j1 + 1] = y0i - y2i;
-            y0r = wk3r * x1r + wk3i * x1i;
-            y0i = wk3r * x1i - wk3i * x1r;
-            y2r = wd3r * x3r + wd3i * x3i;
-            y2i = wd3r * x3i - wd3i * x3r;
-            a[j2] = y0r + y2r;
-            a[j2 + 1] = y0i + y2i;
-            a[j3] = y0r - y2r;
-            a[j3 + 1] = y0i - y2i;
-            x0r = a[j + 2] - a[j2 + 3];
-            x0i = a[j + 3] + a[j2 + 2];
-            x1r = a[j + 2] + a[j2 + 3];
-            x1i = a[j + 3] - a[j2 + 2];
-            x2r = a[j1 + 2] - a[j3 + 3];
-            x2i = a[j1 + 3] + a[j3 + 2];
-            x3r = a[j1 + 2] + a[j3 + 3];
-            x3i = a[j1 + 3] - a[j3 + 2];
-            y0r = wl1r * x0r - wl1i * x0i;
-            y0i = wl1r * x0i + wl1i * x0r;
-            y2r = we1r * x2r - we1i * x2i;
-            y2i = we1r * x2i + we1i * x2r;
-            a[j + 2] = y0r + y2r;
-            a[j + 3] = y0i + y2i;
-            a[j1 + 2] = y0r - y2r;
-            a[j1 + 3] = y0i - y2i;
-            y0r = wl3r * x1r + wl3i * x1i;
-            y0i = wl3r * x1i - wl3i * x1r;
-            y2r = we3r * x3r + we3i * x3i;
-            y2i = we3r * x3i - we3i * x3r;
-            a[j2 + 2] = y0r + y2r;
-            a[j2 + 3] = y0i + y2i;
-            a[j3 + 2] = y0r - y2r;
-            a[j3 + 3] = y0i - y2i;
-            j0 = m - j;
-            j1 = j0 + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j0] - a[j2 + 1];
-            x0i = a[j0 + 1] + a[j2];
-            x1r = a[j0] + a[j2 + 1];
-            x1i = a[j0 + 1] - a[j2];
-            x2r = a[j1] - a[j3 + 1];
-            x2i = a[j1 + 1] + a[j3];
-            x3r = a[j1] + a[j3 + 1];
-            x3i = a[j1 + 1] - a[j3];
-            y0r = wd1i * x0r - wd1r * x0i;
-            y0i = wd1i * x0i + wd1r * x0r;
-            y2r = wk1i * x2r - wk1r * x2i;
-            y2i = wk1i * x2i + wk1r * x2r;
-            a[j0] = y0r + y2r;
-            a[j0 + 1] = y0i + y2i;
-            a[j1] = y0r - y2r;
-            a[j1 + 1] = y0i - y2i;
-            y0r = wd3i * x1r + wd3r * x1i;
-            y0i = wd3i * x1i - wd3r * x1r;
-            y2r = wk3i * x3r + wk3r * x3i;
-            y2i = wk3i * x3i - wk3r * x3r;
-            a[j2] = y0r + y2r;
-            a[j2 + 1] = y0i + y2i;
-            a[j3] = y0r - y2r;
-            a[j3 + 1] = y0i - y2i;
-            x0r = a[j0 - 2] - a[j2 - 1];
-            x0i = a[j0 - 1] + a[j2 - 2];
-            x1r = a[j0 - 2] + a[j2 - 1];
-            x1i = a[j0 - 1] - a[j2 - 2];
-            x2r = a[j1 - 2] - a[j3 - 1];
-            x2i = a[j1 - 1] + a[j3 - 2];
-            x3r = a[j1 - 2] + a[j3 - 1];
-            x3i = a[j1 - 1] - a[j3 - 2];
-            y0r = we1i * x0r - we1r * x0i;
-            y0i = we1i * x0i + we1r * x0r;
-            y2r = wl1i * x2r - wl1r * x2i;
-            y2i = wl1i * x2i + wl1r * x2r;
-            a[j0 - 2] = y0r + y2r;
-            a[j0 - 1] = y0i + y2i;
-            a[j1 - 2] = y0r - y2r;
-            a[j1 - 1] = y0i - y2i;
-            y0r = we3i * x1r + we3r * x1i;
-            y0i = we3i * x1i - we3r * x1r;
-            y2r = wl3i * x3r + wl3r * x3i;
-            y2i = wl3i * x3i - wl3r * x3r;
-            a[j2 - 2] = y0r + y2r;
-            a[j2 - 1] = y0i + y2i;
-            a[j3 - 2] = y0r - y2r;
-            a[j3 - 1] = y0i - y2i;
-            wk1r -= ss1 * wl1i;
-            wk1i += ss1 * wl1r;
-            wk3r -= ss3 * wl3i;
-            wk3i += ss3 * wl3r;
-            wd1r -= ss1 * we1i;
-            wd1i += ss1 * we1r;
-            wd3r -= ss3 * we3i;
-            wd3i += ss3 * we3r;
-        }
-        if (i0 == mh - 4) {
-            break;
-        }
-        wl1r = cos(ew * i0);
-        wl1i = sin(ew * i0);
-        wl3i = 4 * wl1i * wl1r;
-        wl3r = wl1r - wl3i * wl1i;
-        wl3i = wl1i - wl3i * wl1r;
-        we1r = wn4r * (wl1r - wl1i);
-        we1i = wn4r * (wl1i + wl1r);
-        we3r = -wn4r * (wl3r - wl3i);
-        we3i = -wn4r * (wl3i + wl3r);
-        wk1r = w1r * wl1r - w1i * wl1i;
-        wk1i = w1r * wl1i + w1i * wl1r;
-        wk3i = 4 * wk1i * wk1r;
-        wk3r = wk1r - wk3i * wk1i;
-        wk3i = wk1i - wk3i * wk1r;
-        wd1r = wn4r * (wk1r - wk1i);
-        wd1i = wn4r * (wk1i + wk1r);
-        wd3r = -wn4r * (wk3r - wk3i);
-        wd3i = -wn4r * (wk3i + wk3r);
-        i = i0;
+    w = cfttab2(n);
+    for (j = 2; j < mh - 4; j += 4) {
+        wk1r = w[4 * j];
+        wk1i = w[4 * j + 1];
+        wk3r = w[4 * j + 2];
+        wk3i = w[4 * j + 3];
+        wd1r = w[4 * j + 4];
+        wd1i = w[4 * j + 5];
+        wd3r = w[4 * j + 6];
+        wd3i = w[4 * j + 7];
+        wl1r = w[4 * j + 8];
+        wl1i = w[4 * j + 9];
+        wl3r = w[4 * j + 10];
+        wl3i = w[4 * j + 11];
+        we1r = w[4 * j + 12];
+        we1i = w[4 * j + 13];
+        we3r = w[4 * j + 14];
+        we3i = w[4 * j + 15];
+        j1 = j + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j] - a[j2 + 1];
+        x0i = a[j + 1] + a[j2];
+        x1r = a[j] + a[j2 + 1];
+        x1i = a[j + 1] - a[j2];
+        x2r = a[j1] - a[j3 + 1];
+        x2i = a[j1 + 1] + a[j3];
+        x3r = a[j1] + a[j3 + 1];
+        x3i = a[j1 + 1] - a[j3];
+        y0r = wk1r * x0r - wk1i * x0i;
+        y0i = wk1r * x0i + wk1i * x0r;
+        y2r = wd1r * x2r - wd1i * x2i;
+        y2i = wd1r * x2i + wd1i * x2r;
+        a[j] = y0r + y2r;
+        a[j + 1] = y0i + y2i;
+        a[j1] = y0r - y2r;
+        a[j1 + 1] = y0i - y2i;
+        y0r = wk3r * x1r + wk3i * x1i;
+        y0i = wk3r * x1i - wk3i * x1r;
+        y2r = wd3r * x3r + wd3i * x3i;
+        y2i = wd3r * x3i - wd3i * x3r;
+        a[j2] = y0r + y2r;
+        a[j2 + 1] = y0i + y2i;
+        a[j3] = y0r - y2r;
+        a[j3 + 1] = y0i - y2i;
+        x0r = a[j + 2] - a[j2 + 3];
+        x0i = a[j + 3] + a[j2 + 2];
+        x1r = a[j + 2] + a[j2 + 3];
+        x1i = a[j + 3] - a[j2 + 2];
+        x2r = a[j1 + 2] - a[j3 + 3];
+        x2i = a[j1 + 3] + a[j3 + 2];
+        x3r = a[j1 + 2] + a[j3 + 3];
+        x3i = a[j1 + 3] - a[j3 + 2];
+        y0r = wl1r * x0r - wl1i * x0i;
+        y0i = wl1r * x0i + wl1i * x0r;
+        y2r = we1r * x2r - we1i * x2i;
+        y2i = we1r * x2i + we1i * x2r;
+        a[j + 2] = y0r + y2r;
+        a[j + 3] = y0i + y2i;
+        a[j1 + 2] = y0r - y2r;
+        a[j1 + 3] = y0i - y2i;
+        y0r = wl3r * x1r + wl3i * x1i;
+        y0i = wl3r * x1i - wl3i * x1r;
+        y2r = we3r * x3r + we3i * x3i;
+        y2i = we3r * x3i - we3i * x3r;
+        a[j2 + 2] = y0r + y2r;
+        a[j2 + 3] = y0i + y2i;
+        a[j3 + 2] = y0r - y2r;
+        a[j3 + 3] = y0i - y2i;
+        j0 = m - j;
+        j1 = j0 + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j0] - a[j2 + 1];
+        x0i = a[j0 + 1] + a[j2];
+        x1r = a[j0] + a[j2 + 1];
+        x1i = a[j0 + 1] - a[j2];
+        x2r = a[j1] - a[j3 + 1];
+        x2i = a[j1 + 1] + a[j3];
+        x3r = a[j1] + a[j3 + 1];
+        x3i = a[j1 + 1] - a[j3];
+        y0r = wd1i * x0r - wd1r * x0i;
+        y0i = wd1i * x0i + wd1r * x0r;
+        y2r = wk1i * x2r - wk1r * x2i;
+        y2i = wk1i * x2i + wk1r * x2r;
+        a[j0] = y0r + y2r;
+        a[j0 + 1] = y0i + y2i;
+        a[j1] = y0r - y2r;
+        a[j1 + 1] = y0i - y2i;
+        y0r = wd3i * x1r + wd3r * x1i;
+        y0i = wd3i * x1i - wd3r * x1r;
+        y2r = wk3i * x3r + wk3r * x3i;
+        y2i = wk3i * x3i - wk3r * x3r;
+        a[j2] = y0r + y2r;
+        a[j2 + 1] = y0i + y2i;
+        a[j3] = y0r - y2r;
+        a[j3 + 1] = y0i - y2i;
+        x0r = a[j0 - 2] - a[j2 - 1];
+        x0i = a[j0 - 1] + a[j2 - 2];
+        x1r = a[j0 - 2] + a[j2 - 1];
+        x1i = a[j0 - 1] - a[j2 - 2];
+        x2r = a[j1 - 2] - a[j3 - 1];
+        x2i = a[j1 - 1] + a[j3 - 2];
+        x3r = a[j1 - 2] + a[j3 - 1];
+        x3i = a[j1 - 1] - a[j3 - 2];
+        y0r = we1i * x0r - we1r * x0i;
+        y0i = we1i * x0i + we1r * x0r;
+        y2r = wl1i * x2r - wl1r * x2i;
+        y2i = wl1i * x2i + wl1r * x2r;
+        a[j0 - 2] = y0r + y2r;
+        a[j0 - 1] = y0i + y2i;
+        a[j1 - 2] = y0r - y2r;
+        a[j1 - 1] = y0i - y2i;
+        y0r = we3i * x1r + we3r * x1i;
+        y0i = we3i * x1i - we3r * x1r;
+        y2r = wl3i * x3r + wl3r * x3i;
+        y2i = wl3i * x3i - wl3r * x3r;
+        a[j2 - 2] = y0r + y2r;
+        a[j2 - 1] = y0i + y2i;
+        a[j3 - 2] = y0r - y2r;
+        a[j3 - 1] = y0i - y2i;
     }
+    wk1r = w[4 * mh - 8];
+    wk1i = w[4 * mh - 7];
+    wk3r = w[4 * mh - 6];
+    wk3i = w[4 * mh - 5];
+    wd1r = w[4 * mh - 4];
+    wd1i = w[4 * mh - 3];
+    wd3r = w[4 * mh - 2];
+    wd3i = w[4 * mh - 1];
     wl1r = WR2500;
     wl1i = WI2500;
     j0 = mh;
@@ -2976,58 +2973,36 @@ void cftx020(double *a)
 
 void rftfsub(int n, double *a)
 {
-    int i, i0, j, k;
-    double ec, w1r, w1i, wkr, wki, wdr, wdi, ss, xr, xi, yr, yi;
+    int j, k;
+    const double *w;
+    double wkr, wki, wdr, wdi, xr, xi, yr, yi;
     
-    ec = 2 * M_PI_2 / n;
-    wkr = 0;
-    wki = 0;
-    wdi = cos(ec);
-    wdr = sin(ec);
-    wdi *= wdr;
-    wdr *= wdr;
-    w1r = 1 - 2 * wdr;
-    w1i = 2 * wdi;
-    ss = 2 * w1i;
-    i = n >> 1;
-    for (;;) {
-        i0 = i - 4 * RDFT_LOOP_DIV;
-        if (i0 < 4) {
-            i0 = 4;
-        }
-        for (j = i - 4; j >= i0; j -= 4) {
-            k = n - j;
-            xr = a[j + 2] - a[k - 2];
-            xi = a[j + 3] + a[k - 1];
-            yr = wdr * xr - wdi * xi;
-            yi = wdr * xi + wdi * xr;
-            a[j + 2] -= yr;
-            a[j + 3] -= yi;
-            a[k - 2] += yr;
-            a[k - 1] -= yi;
-            wkr += ss * wdi;
-            wki += ss * (0.5 - wdr);
-            xr = a[j] - a[k];
-            xi = a[j + 1] + a[k + 1];
-            yr = wkr * xr - wki * xi;
-            yi = wkr * xi + wki * xr;
-            a[j] -= yr;
-            a[j + 1] -= yi;
-            a[k] += yr;
-            a[k + 1] -= yi;
-            wdr += ss * wki;
-            wdi += ss * (0.5 - wkr);
-        }
-        if (i0 == 4) {
-            break;
-        }
-        wkr = 0.5 * sin(ec * i0);
-        wki = 0.5 * cos(ec * i0);
-        wdr = 0.5 - (wkr * w1r - wki * w1i);
-        wdi = wkr * w1i + wki * w1r;
-        wkr = 0.5 - wkr;
-        i = i0;
+    w = rfttab(n);
+    for (j = (n >> 1) - 4; j >= 4; j -= 4) {
+        k = n - j;
+        wdr = w[j + 2];
+        wdi = w[j + 3];
+        xr = a[j + 2] - a[k - 2];
+        xi = a[j + 3] + a[k - 1];
+        yr = wdr * xr - wdi * xi;
+        yi = wdr * xi + wdi * xr;
+        a[j + 2] -= yr;
+        a[j + 3] -= yi;
+        a[k - 2] += yr;
+        a[k - 1] -= yi;
+        wkr = w[j];
+        wki = w[j + 1];
+        xr = a[j] - a[k];
+        xi = a[j + 1] + a[k + 1];
+        yr = wkr * xr - wki * xi;
+        yi = wkr * xi + wki * xr;
+        a[j] -= yr;
+        a[j + 1] -= yi;
+        a[k] += yr;
+        a[k + 1] -= yi;
     }
+    wdr = w[2];
+    wdi = w[3];
     xr = a[2] - a[n - 2];
     xi = a[3] + a[n - 1];
     yr = wdr * xr - wdi * xi;
@@ -3041,58 +3016,36 @@ void rftfsub(int n, double *a)
 
 void rftbsub(int n, double *a)
 {
-    int i, i0, j, k;
-    double ec, w1r, w1i, wkr, wki, wdr, wdi, ss, xr, xi, yr, yi;
+    int j, k;
+    const double *w;
+    double wkr, wki, wdr, wdi, xr, xi, yr, yi;
     
-    ec = 2 * M_PI_2 / n;
-    wkr = 0;
-    wki = 0;
-    wdi = cos(ec);
-    wdr = sin(ec);
-    wdi *= wdr;
-    wdr *= wdr;
-    w1r = 1 - 2 * wdr;
-    w1i = 2 * wdi;
-    ss = 2 * w1i;
-    i = n >> 1;
-    for (;;) {
-        i0 = i - 4 * RDFT_LOOP_DIV;
-        if (i0 < 4) {
-            i0 = 4;
-        }
-        for (j = i - 4; j >= i0; j -= 4) {
-            k = n - j;
-            xr = a[j + 2] - a[k - 2];
-            xi = a[j + 3] + a[k - 1];
-            yr = wdr * xr + wdi * xi;
-            yi = wdr * xi - wdi * xr;
-            a[j + 2] -= yr;
-            a[j + 3] -= yi;
-            a[k - 2] += yr;
-            a[k - 1] -= yi;
-            wkr += ss * wdi;
-            wki += ss * (0.5 - wdr);
-            xr = a[j] - a[k];
-            xi = a[j + 1] + a[k + 1];
-            yr = wkr * xr + wki * xi;
-            yi = wkr * xi - wki * xr;
-            a[j] -= yr;
-            a[j + 1] -= yi;
-            a[k] += yr;
-            a[k + 1] -= yi;
-            wdr += ss * wki;
-            wdi += ss * (0.5 - wkr);
-        }
-        if (i0 == 4) {
-            break;
-        }
-        wkr = 0.5 * sin(ec * i0);
-        wki = 0.5 * cos(ec * i0);
-        wdr = 0.5 - (wkr * w1r - wki * w1i);
-        wdi = wkr * w1i + wki * w1r;
-        wkr = 0.5 - wkr;
-        i = i0;
+    w = rfttab(n);
+    for (j = (n >> 1) - 4; j >= 4; j -= 4) {
+        k = n - j;
+        wdr = w[j + 2];
+        wdi = w[j + 3];
+        xr = a[j + 2] - a[k - 2];
+        xi = a[j + 3] + a[k - 1];
+        yr = wdr * xr + wdi * xi;
+        yi = wdr * xi - wdi * xr;
+        a[j + 2] -= yr;
+        a[j + 3] -= yi;
+        a[k - 2] += yr;
+        a[k - 1] -= yi;
+        wkr = w[j];
+        wki = w[j + 1];
+        xr = a[j] - a[k];
+        xi = a[j + 1] + a[k + 1];
+        yr = wkr * xr + wki * xi;
+        yi = wkr * xi - wki * xr;
+        a[j] -= yr;
+        a[j + 1] -= yi;
+        a[k] += yr;
+        a[k + 1] -= yi;
     }
+    wdr = w[2];
+    wdi = w[3];
     xr = a[2] - a[n - 2];
     xi = a[3] + a[n - 1];
     yr = wdr * xr + wdi * xi;